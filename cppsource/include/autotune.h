@@ -0,0 +1,141 @@
+/**
+ * @file autotune.h
+ * @brief Online choice of the coroutine interleave depth and prefetch
+ * policy.
+ *
+ * The best task count moves with the datagram size, the number of
+ * sensors and the cache size, so it is measured rather than set. Each
+ * candidate (task count, prefetch on or off) is timed over short
+ * calibration slices; after each round, in which every surviving
+ * candidate runs one slice, the slower half is dropped (successive
+ * halving) until one is left. Costs are means over all the slices a
+ * candidate has run, so the survivors are measured more often.
+ *
+ * Once settled, the tuner watches for a reason to start again: a
+ * working set that has grown or shrunk by more than the tolerance, or
+ * full runs whose cost has drifted by more than the tolerance from the
+ * first full run after tuning, twice in a row.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+struct autotune_candidate_t {
+  uint16_t task_count;
+  bool prefetch;
+  double cost; // Total over samples slices
+  uint32_t samples;
+  double mean_cost() const { return samples ? cost / samples : 0.0; }
+};
+
+#define AUTOTUNE_REASON_START 0
+#define AUTOTUNE_REASON_WORKING_SET 1
+#define AUTOTUNE_REASON_DRIFT 2
+
+inline const char* autotune_reason_name(int reason) {
+  static const char* names[] = { "start", "working_set", "drift" };
+  return (reason >= 0 && reason <= AUTOTUNE_REASON_DRIFT) ? names[reason] : "unknown";
+}
+
+class interleave_autotuner {
+public:
+  explicit interleave_autotuner(double tolerance = 0.25)
+  : tolerance_(tolerance)
+  {
+  }
+
+  // Starts tuning over each task count, with and without prefetch
+  void start(uint64_t working_set, const std::vector<uint16_t>& task_counts) {
+    candidates_.clear();
+    live_.clear();
+    for (uint16_t tasks : task_counts) {
+      for (bool prefetch : { true, false }) {
+        live_.push_back(candidates_.size());
+        candidates_.push_back({ tasks, prefetch, 0.0, 0 });
+      }
+    }
+    working_set_ = working_set;
+    slot_ = 0;
+    round_ = 0;
+    baseline_ = 0.0;
+    drifts_ = 0;
+    drifted_ = false;
+  }
+
+  bool tuning() const { return live_.size() > 1; }
+  size_t round() const { return round_; }
+
+  // The candidate for the next calibration slice
+  const autotune_candidate_t& next() const { return candidates_[live_[slot_]]; }
+
+  // Records the cost of the slice run with next()
+  void record(double cost) {
+    autotune_candidate_t& c = candidates_[live_[slot_]];
+    c.cost += cost;
+    c.samples++;
+    if (++slot_ < live_.size()) {
+      return;
+    }
+    // End of a round: keep the cheaper half
+    std::stable_sort(live_.begin(), live_.end(), [this](size_t a, size_t b) {
+      return candidates_[a].mean_cost() < candidates_[b].mean_cost();
+    });
+    live_.resize((live_.size() + 1) / 2);
+    slot_ = 0;
+    round_++;
+  }
+
+  // The fastest candidate, once tuning() is false
+  const autotune_candidate_t& chosen() const { return candidates_[live_[0]]; }
+
+  /**
+   * @brief Whether to tune again before the next run, and if so, why
+   *
+   * @param working_set bytes touched by the next run
+   * @param reason set to an AUTOTUNE_REASON_ value if true
+   */
+  bool should_retune(uint64_t working_set, int& reason) const {
+    if (live_.empty()) {
+      reason = AUTOTUNE_REASON_START;
+      return true;
+    }
+    if (differs(working_set, working_set_)) {
+      reason = AUTOTUNE_REASON_WORKING_SET;
+      return true;
+    }
+    if (drifted_) {
+      reason = AUTOTUNE_REASON_DRIFT;
+      return true;
+    }
+    return false;
+  }
+
+  // Records the cost of a full run with the chosen candidate
+  void observe(double cost) {
+    if (baseline_ == 0.0) {
+      baseline_ = cost;
+      return;
+    }
+    drifts_ = differs(cost, baseline_) ? drifts_ + 1 : 0;
+    drifted_ = (drifts_ >= 2);
+  }
+
+private:
+  bool differs(double value, double reference) const {
+    return std::fabs(value - reference) > tolerance_ * reference;
+  }
+
+  double tolerance_;
+  std::vector<autotune_candidate_t> candidates_;
+  std::vector<size_t> live_; // Surviving candidates
+  size_t slot_ = 0; // Position in live_ this round
+  size_t round_ = 0;
+  uint64_t working_set_ = 0;
+  double baseline_ = 0.0;
+  uint32_t drifts_ = 0;
+  bool drifted_ = false;
+};
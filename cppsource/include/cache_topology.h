@@ -0,0 +1,195 @@
+/**
+ * @file cache_topology.h
+ * @brief The data cache line size and the size of each cache level, as
+ * found on the machine at startup.
+ *
+ * Sources are tried in turn: sysfs (Linux), sysconf, then CPUID (x86).
+ * Whatever none of them reports keeps a default, so the caller always
+ * gets a usable topology; source says where the line size came from.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#define CACHE_TOPOLOGY_DEFAULT_LINE 64
+#define CACHE_TOPOLOGY_DEFAULT_L1D (32 * 1024)
+#define CACHE_TOPOLOGY_DEFAULT_L2 (512 * 1024)
+#define CACHE_TOPOLOGY_DEFAULT_LLC (4 * 1024 * 1024)
+
+struct cache_level_t {
+  uint16_t level;
+  size_t size; // Bytes
+  size_t line_size;
+};
+
+struct cache_topology_t {
+  size_t line_size = CACHE_TOPOLOGY_DEFAULT_LINE;
+  size_t l1d = CACHE_TOPOLOGY_DEFAULT_L1D;
+  size_t l2 = CACHE_TOPOLOGY_DEFAULT_L2;
+  size_t llc = CACHE_TOPOLOGY_DEFAULT_LLC; // Last level
+  const char* source = "default";
+  std::vector<cache_level_t> levels; // Data and unified caches, as found
+
+  void dump(std::ostream& os) const {
+    os << "cache_source"
+       << "\t" << source << std::endl;
+    os << "cache_line"
+       << "\t" << line_size << std::endl;
+    os << "cache_l1d"
+       << "\t" << l1d << std::endl;
+    os << "cache_l2"
+       << "\t" << l2 << std::endl;
+    os << "cache_llc"
+       << "\t" << llc << std::endl;
+  }
+};
+
+// Parses a sysfs cache size such as "48K", "1024K" or "32M"; 0 if not a size
+inline size_t parse_cache_size(const std::string& text) {
+  char* end = nullptr;
+  unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+  if (end == text.c_str()) {
+    return 0;
+  }
+  switch (*end) {
+  case 'K': case 'k': return value * 1024;
+  case 'M': case 'm': return value * 1024 * 1024;
+  case 'G': case 'g': return value * 1024 * 1024 * 1024;
+  default: return value;
+  }
+}
+
+inline bool is_plausible_line_size(size_t bytes) {
+  return bytes >= 16 && bytes <= 512 && (bytes & (bytes - 1)) == 0;
+}
+
+/**
+ * @brief Sets l1d, l2 and llc from levels, which holds the data and
+ * unified caches in any order. llc is the highest level from 3 up; a
+ * level that is not reported keeps its default, and each level is made
+ * at least as large as the one below, so llc is never just an L1 or L2.
+ */
+inline void cache_topology_from_levels(cache_topology_t& topology) {
+  uint16_t last = 0;
+  for (const cache_level_t& c : topology.levels) {
+    if (c.size == 0) {
+      continue;
+    }
+    if (c.level == 1) {
+      topology.l1d = c.size;
+      if (is_plausible_line_size(c.line_size)) {
+        topology.line_size = c.line_size;
+      }
+    } else if (c.level == 2) {
+      topology.l2 = c.size;
+    } else if (c.level >= 3 && c.level >= last) {
+      last = c.level;
+      topology.llc = c.size;
+    }
+  }
+  topology.l2 = std::max(topology.l2, topology.l1d);
+  topology.llc = std::max(topology.llc, topology.l2);
+}
+
+inline bool read_sysfs_line(const std::string& path, std::string& value) {
+  std::ifstream in(path);
+  return static_cast<bool>(std::getline(in, value));
+}
+
+inline bool cache_levels_from_sysfs(std::vector<cache_level_t>& levels) {
+  const std::string base = "/sys/devices/system/cpu/cpu0/cache/index";
+  for (int index = 0; index < 16; index++) {
+    std::string dir = base + std::to_string(index) + "/";
+    std::string level, type, size, line;
+    if (!read_sysfs_line(dir + "level", level)) {
+      break;
+    }
+    if (!read_sysfs_line(dir + "type", type) || type == "Instruction") {
+      continue;
+    }
+    read_sysfs_line(dir + "size", size);
+    read_sysfs_line(dir + "coherency_line_size", line);
+    levels.push_back({ (uint16_t)std::atoi(level.c_str()), parse_cache_size(size),
+      (size_t)std::strtoull(line.c_str(), nullptr, 10) });
+  }
+  return !levels.empty();
+}
+
+inline bool cache_levels_from_sysconf(std::vector<cache_level_t>& levels) {
+#if defined(_SC_LEVEL1_DCACHE_SIZE)
+  long line = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+  const long sizes[] = {
+    sysconf(_SC_LEVEL1_DCACHE_SIZE),
+    sysconf(_SC_LEVEL2_CACHE_SIZE),
+    sysconf(_SC_LEVEL3_CACHE_SIZE),
+    sysconf(_SC_LEVEL4_CACHE_SIZE),
+  };
+  for (uint16_t i = 0; i < 4; i++) {
+    if (sizes[i] > 0) {
+      levels.push_back({ (uint16_t)(i + 1), (size_t)sizes[i], line > 0 ? (size_t)line : 0 });
+    }
+  }
+#else
+  (void)levels;
+#endif
+  return !levels.empty();
+}
+
+// Deterministic cache parameters: leaf 4 (Intel), else 0x8000001D (AMD)
+inline bool cache_levels_from_cpuid(std::vector<cache_level_t>& levels) {
+#if defined(__x86_64__) || defined(__i386__)
+  for (unsigned leaf : { 4u, 0x8000001Du }) {
+    unsigned max_leaf = __get_cpuid_max(leaf & 0x80000000u, nullptr);
+    if (max_leaf < leaf) {
+      continue;
+    }
+    for (unsigned sub = 0; sub < 16; sub++) {
+      unsigned eax, ebx, ecx, edx;
+      __cpuid_count(leaf, sub, eax, ebx, ecx, edx);
+      unsigned type = eax & 0x1f; // 1 data, 2 instruction, 3 unified
+      if (type == 0) {
+        break;
+      }
+      if (type == 2) {
+        continue;
+      }
+      size_t line = (ebx & 0xfff) + 1;
+      size_t partitions = ((ebx >> 12) & 0x3ff) + 1;
+      size_t ways = ((ebx >> 22) & 0x3ff) + 1;
+      size_t sets = (size_t)ecx + 1;
+      levels.push_back({ (uint16_t)((eax >> 5) & 0x7), ways * partitions * line * sets, line });
+    }
+    if (!levels.empty()) {
+      return true;
+    }
+  }
+#else
+  (void)levels;
+#endif
+  return false;
+}
+
+inline cache_topology_t discover_cache_topology() {
+  cache_topology_t topology;
+  if (cache_levels_from_sysfs(topology.levels)) {
+    topology.source = "sysfs";
+  } else if (cache_levels_from_sysconf(topology.levels)) {
+    topology.source = "sysconf";
+  } else if (cache_levels_from_cpuid(topology.levels)) {
+    topology.source = "cpuid";
+  }
+  cache_topology_from_levels(topology);
+  return topology;
+}
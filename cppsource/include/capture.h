@@ -0,0 +1,227 @@
+/**
+ * @file capture.h
+ * @brief A binary capture of sensor datagrams, written as they arrive
+ * and replayed from a read-only mapping of the file.
+ *
+ * Layout (host byte order):
+ *   capture_header_t (64 bytes)
+ *   sensor_count sensor IDs of CAPTURE_ID_BYTES each
+ *   padding to record_offset (a page boundary)
+ *   record_count records of record_stride bytes: one datagram each,
+ *     padded to a cache line so that every record starts on one
+ *   at index_offset, period_count uint64_t: the record count at the
+ *     end of each period, so period p is [end[p-1], end[p])
+ *
+ * Records are what the receiver would have been handed, so replaying
+ * needs no parsing: each record is a datagram_t in place.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CAPTURE_MAGIC "INF7CAP"
+#define CAPTURE_VERSION 1
+#define CAPTURE_ID_BYTES 16
+#define CAPTURE_RECORD_ALIGN 64
+#define CAPTURE_DATA_ALIGN 4096
+
+struct capture_header_t {
+  char magic[8]; // CAPTURE_MAGIC, null-terminated
+  uint32_t version;
+  uint32_t datagram_size; // Bytes of each record that are the datagram
+  uint32_t sensor_count;
+  uint32_t sample_count; // Per sensor per period, as sent
+  uint32_t record_stride;
+  uint32_t period_count;
+  uint64_t record_offset;
+  uint64_t record_count;
+  uint64_t index_offset;
+  uint8_t reserved[8];
+};
+static_assert(sizeof(capture_header_t) == 64, "capture_header_t is 64 bytes on disk");
+
+inline uint32_t capture_record_stride(uint32_t datagram_size) {
+  return (datagram_size + CAPTURE_RECORD_ALIGN - 1) & ~(uint32_t)(CAPTURE_RECORD_ALIGN - 1);
+}
+
+/**
+ * @brief Appends datagrams to a capture file; close() (or the
+ * destructor) writes the period index and the final header
+ */
+class capture_writer {
+public:
+  /**
+   * @param sensor_ids sensor_count IDs of CAPTURE_ID_BYTES each, contiguous
+   */
+  capture_writer(const std::string& path, const void* sensor_ids, uint32_t sensor_count,
+    uint32_t sample_count, uint32_t datagram_size)
+  : os_(path, std::ios::binary | std::ios::out | std::ios::trunc), path_(path)
+  {
+    if (!os_) {
+      throw std::runtime_error("capture " + path + ": cannot open for writing");
+    }
+    memset(&header_, 0, sizeof(header_));
+    memcpy(header_.magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+    header_.version = CAPTURE_VERSION;
+    header_.datagram_size = datagram_size;
+    header_.sensor_count = sensor_count;
+    header_.sample_count = sample_count;
+    header_.record_stride = capture_record_stride(datagram_size);
+    uint64_t ids_end = sizeof(header_) + (uint64_t)sensor_count * CAPTURE_ID_BYTES;
+    header_.record_offset = (ids_end + CAPTURE_DATA_ALIGN - 1) & ~(uint64_t)(CAPTURE_DATA_ALIGN - 1);
+    // The header is rewritten with the counts on close()
+    os_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+    os_.write(static_cast<const char*>(sensor_ids), (std::streamsize)sensor_count * CAPTURE_ID_BYTES);
+    padding_.assign(std::max<uint64_t>(header_.record_offset - ids_end, CAPTURE_RECORD_ALIGN), 0);
+    os_.write(padding_.data(), (std::streamsize)(header_.record_offset - ids_end));
+    check();
+  }
+  capture_writer(const capture_writer&) = delete;
+  capture_writer& operator=(const capture_writer&) = delete;
+  ~capture_writer() {
+    try {
+      close();
+    } catch (...) {
+    }
+  }
+
+  // Appends one datagram of datagram_size bytes
+  void write(const void* datagram) {
+    os_.write(static_cast<const char*>(datagram), header_.datagram_size);
+    os_.write(padding_.data(), header_.record_stride - header_.datagram_size);
+    header_.record_count++;
+  }
+  // Closes the current period, unless it is empty
+  void end_period() {
+    uint64_t begin = period_ends_.empty() ? 0 : period_ends_.back();
+    if (header_.record_count > begin) {
+      period_ends_.push_back(header_.record_count);
+    }
+  }
+  void close() {
+    if (!os_.is_open()) {
+      return;
+    }
+    end_period();
+    header_.period_count = (uint32_t)period_ends_.size();
+    header_.index_offset = header_.record_offset + header_.record_count * header_.record_stride;
+    os_.write(reinterpret_cast<const char*>(period_ends_.data()),
+      (std::streamsize)(period_ends_.size() * sizeof(uint64_t)));
+    os_.seekp(0);
+    os_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+    check();
+    os_.close();
+  }
+  uint64_t record_count() const { return header_.record_count; }
+
+private:
+  void check() {
+    if (!os_) {
+      throw std::runtime_error("capture " + path_ + ": write failed");
+    }
+  }
+
+  std::ofstream os_;
+  std::string path_;
+  capture_header_t header_;
+  std::vector<char> padding_;
+  std::vector<uint64_t> period_ends_;
+};
+
+/**
+ * @brief A capture file mapped read-only; throws std::runtime_error if
+ * it cannot be mapped or is not a well-formed capture
+ */
+class capture_file {
+public:
+  explicit capture_file(const std::string& path) : path_(path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      fail(strerror(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(capture_header_t)) {
+      close(fd);
+      fail("too short for a capture");
+    }
+    bytes_ = (size_t)st.st_size;
+    // Populated up front: replay should run at memory speed, not fault in pages
+    void* base = mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+      fail(strerror(errno));
+    }
+    base_ = static_cast<const char*>(base);
+    madvise(base, bytes_, MADV_SEQUENTIAL);
+    try {
+      validate();
+    } catch (...) {
+      munmap(const_cast<char*>(base_), bytes_);
+      throw;
+    }
+  }
+  capture_file(const capture_file&) = delete;
+  capture_file& operator=(const capture_file&) = delete;
+  ~capture_file() {
+    munmap(const_cast<char*>(base_), bytes_);
+  }
+
+  const capture_header_t& header() const { return *reinterpret_cast<const capture_header_t*>(base_); }
+  const uint8_t* sensor_id(size_t i) const {
+    return reinterpret_cast<const uint8_t*>(base_ + sizeof(capture_header_t) + (i * CAPTURE_ID_BYTES));
+  }
+  const char* record(uint64_t i) const {
+    return base_ + header().record_offset + (i * header().record_stride);
+  }
+  // Period p is records [period_begin(p), period_end(p))
+  uint64_t period_begin(uint32_t p) const { return (p == 0) ? 0 : period_end(p - 1); }
+  uint64_t period_end(uint32_t p) const {
+    return reinterpret_cast<const uint64_t*>(base_ + header().index_offset)[p];
+  }
+
+private:
+  [[noreturn]] void fail(const std::string& why) const {
+    throw std::runtime_error("capture " + path_ + ": " + why);
+  }
+  void validate() const {
+    const capture_header_t& h = header();
+    if (memcmp(h.magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0) {
+      fail("not a capture file");
+    }
+    if (h.version != CAPTURE_VERSION) {
+      fail("version " + std::to_string(h.version) + " is not supported");
+    }
+    if (h.datagram_size == 0 || h.record_stride < h.datagram_size || (h.record_stride % CAPTURE_RECORD_ALIGN) != 0) {
+      fail("bad record size");
+    }
+    uint64_t ids_end = sizeof(capture_header_t) + (uint64_t)h.sensor_count * CAPTURE_ID_BYTES;
+    if (h.record_offset < ids_end || (h.record_offset % CAPTURE_DATA_ALIGN) != 0
+      || h.index_offset != h.record_offset + h.record_count * h.record_stride
+      || h.index_offset + (uint64_t)h.period_count * sizeof(uint64_t) > bytes_) {
+      fail("truncated or inconsistent");
+    }
+    uint64_t last = 0;
+    for (uint32_t p = 0; p < h.period_count; p++) {
+      if (period_end(p) < last || period_end(p) > h.record_count) {
+        fail("bad period index");
+      }
+      last = period_end(p);
+    }
+  }
+
+  std::string path_;
+  const char* base_ = nullptr;
+  size_t bytes_ = 0;
+};
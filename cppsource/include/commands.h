@@ -0,0 +1,12 @@
+#ifndef COMMANDS_H
+#define COMMANDS_H
+
+// Command frames carry a reserved sensor ID (all bits set) and the
+// command in place of the sequence number: { SENSOR_ID_CMD, cmd, 0* }
+#define CMD_ID_RESET_SEQUENCES  ((uint32_t)0)
+#define CMD_ID_STOP_SERVER      ((uint32_t)1)
+#define CMD_ID_USE_SEQ          ((uint32_t)2)
+#define CMD_ID_USE_CORO         ((uint32_t)3)
+#define CMD_ID_USE_BOTH         ((uint32_t)4)
+
+#endif // COMMANDS_H
@@ -29,11 +29,7 @@ struct x_row_t {
 
 // Command frames contain { SENSOR_ID_CMD, cmd, 0* }
 #define SENSOR_ID_CMD           ((id_t)-1)
-#define CMD_ID_RESET_SEQUENCES  ((id_t)0)
-#define CMD_ID_STOP_SERVER      ((id_t)1)
-#define CMD_ID_USE_SEQ          ((id_t)2)
-#define CMD_ID_USE_CORO         ((id_t)3)
-#define CMD_ID_USE_BOTH         ((id_t)4)
+#include <commands.h>
 
 // Execution models and patterns for selecting model
 #define EXEC_MODEL_SEQ    0
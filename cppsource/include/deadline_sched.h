@@ -0,0 +1,101 @@
+/**
+ * @file deadline_sched.h
+ * @brief Items launched earliest deadline first, with deadline misses
+ * and latency kept per priority class.
+ *
+ * Each item is pushed with its priority class, the time it was released
+ * (its input was ready) and an absolute deadline, both ns on the steady
+ * clock. deadline_source is a source for
+ * coroutine_ring_runner::run_source(): next() pops the item with the
+ * earliest deadline, and complete() (called by the runner when the
+ * item's task finishes) records its latency from its release.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <vector>
+#include <tlx/container/d_ary_heap.hpp>
+
+#define PRIORITY_CLASS_ALARM 0 // The sensor's last result was positive
+#define PRIORITY_CLASS_NORMAL 1
+#define PRIORITY_CLASS_COUNT 2
+
+inline const char* priority_class_name(int priority_class) {
+  static const char* names[] = { "alarm", "normal" };
+  return (priority_class >= 0 && priority_class < PRIORITY_CLASS_COUNT) ? names[priority_class] : "unknown";
+}
+
+inline uint64_t deadline_clock_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct deadline_stats_t {
+  uint64_t count;
+  uint64_t misses;
+  uint64_t latency_total; // ns
+  uint64_t latency_max; // ns
+  double mean_latency() const { return count ? (double)latency_total / (double)count : 0.0; }
+};
+
+class deadline_source {
+public:
+  // Empties the queue and the stats
+  void reset(size_t item_count) {
+    heap_.clear();
+    heap_.reserve(item_count);
+    items_.resize(item_count);
+    for (deadline_stats_t& s : stats_) {
+      s = { 0, 0, 0, 0 };
+    }
+  }
+
+  void push(size_t item, int priority_class, uint64_t released_at, uint64_t deadline) {
+    items_[item] = { deadline, released_at, (uint32_t)item, (uint16_t)priority_class };
+    heap_.push(items_[item]);
+  }
+
+  // The pending item with the earliest deadline; ties go to the lower item
+  bool next(size_t& item) {
+    if (heap_.empty()) {
+      return false;
+    }
+    item = heap_.extract_top().item;
+    return true;
+  }
+
+  void complete(size_t item) {
+    uint64_t now = deadline_clock_ns();
+    const entry_t& e = items_[item];
+    deadline_stats_t& s = stats_[e.priority_class];
+    uint64_t latency = (now > e.released_at) ? now - e.released_at : 0;
+    s.count++;
+    s.misses += (now > e.deadline) ? 1 : 0;
+    s.latency_total += latency;
+    s.latency_max = std::max(s.latency_max, latency);
+  }
+
+  // Of the last run
+  const deadline_stats_t& stats(int priority_class) const { return stats_[priority_class]; }
+
+private:
+  struct entry_t {
+    uint64_t deadline;
+    uint64_t released_at;
+    uint32_t item;
+    uint16_t priority_class;
+  };
+  struct earlier {
+    bool operator()(const entry_t& a, const entry_t& b) const {
+      return (a.deadline != b.deadline) ? (a.deadline < b.deadline) : (a.item < b.item);
+    }
+  };
+
+  tlx::DAryHeap<entry_t, 4, earlier> heap_;
+  std::vector<entry_t> items_; // By item, for complete()
+  deadline_stats_t stats_[PRIORITY_CLASS_COUNT];
+};
@@ -0,0 +1,82 @@
+/**
+ * @file load_gen.h
+ * @brief Open-loop arrival schedules, and latency percentiles.
+ *
+ * arrival_schedule gives the intended arrival time of each datagram at
+ * an aggregate rate, with fixed gaps or exponential ones (a Poisson
+ * process). The schedule never waits for the system under test, so a
+ * stall delays every datagram due during it. Latency is measured from
+ * the intended time, not from when a datagram was actually handed
+ * over, so that delay is counted rather than omitted.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#define ARRIVALS_FIXED 0
+#define ARRIVALS_POISSON 1
+
+class arrival_schedule {
+public:
+  /**
+   * @param rate arrivals per second, greater than 0
+   * @param arrivals ARRIVALS_FIXED or ARRIVALS_POISSON
+   */
+  arrival_schedule(double rate, int arrivals, uint64_t seed = 5489)
+  : mean_gap_ns_(1e9 / rate), arrivals_(arrivals), engine_(seed)
+  {
+  }
+
+  // Offset of the next arrival from the start of the schedule (ns); the first is at 0
+  uint64_t next() {
+    uint64_t at = (uint64_t)at_;
+    at_ += (arrivals_ == ARRIVALS_POISSON) ? gap_(engine_) * mean_gap_ns_ : mean_gap_ns_;
+    return at;
+  }
+
+private:
+  double mean_gap_ns_;
+  int arrivals_;
+  double at_ = 0.0; // Kept in double, so fixed gaps do not drift by rounding
+  std::mt19937_64 engine_;
+  std::exponential_distribution<double> gap_; // Mean 1
+};
+
+class latency_recorder {
+public:
+  void add(uint64_t ns) {
+    samples_.push_back(ns);
+    sorted_ = false;
+  }
+  size_t count() const { return samples_.size(); }
+
+  // Nearest rank, for p in [0, 100]; 0 if there are no samples
+  uint64_t percentile(double p) {
+    if (samples_.empty()) {
+      return 0;
+    }
+    sort();
+    size_t rank = (size_t)std::ceil((p / 100.0) * (double)samples_.size());
+    rank = std::min(std::max<size_t>(rank, 1), samples_.size());
+    return samples_[rank - 1];
+  }
+  uint64_t max() {
+    return percentile(100.0);
+  }
+
+private:
+  void sort() {
+    if (!sorted_) {
+      std::sort(samples_.begin(), samples_.end());
+      sorted_ = true;
+    }
+  }
+
+  std::vector<uint64_t> samples_; // ns
+  bool sorted_ = true;
+};
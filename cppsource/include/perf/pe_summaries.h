@@ -11,6 +11,7 @@ enum EMI_SUMMARIES
   EMI_SEQ_START = 0,
   EMI_CORO,
   EMI_SEQ_END,
+  EMI_TUNE, // Auto-tuner calibration slices
 
   EMI_COUNT
 };
@@ -20,6 +21,7 @@ const char** pe_summary_get_names() {
     "seq_start",
     "coro",
     "seq_end",
+    "tune",
     0
   };
   return emi_summary_names;
@@ -2,6 +2,7 @@
 #define __PREFETCH1_H__
 
 #include <stddef.h>
+#include <stdint.h>
 
 ///////////////////////////////////////////////////////////////////
 // Prefetch
@@ -20,14 +21,20 @@
 #define PREFETCHW(p) _mm_prefetch((const char*)p, _MM_HINT_ENTA) // See Because _MM_HINT_ET1 is not implemented yet
 #endif
 
-// TODO - drive this value from arch
+// Unit of alignment for data that threads must not share, fixed at
+// build time. Prefetches step by pf_line_size, which is set at startup
+// from the cache topology (cache_topology.h).
+#ifndef LINE_SIZE
 #define LINE_SIZE 64
+#endif
+
+inline size_t pf_line_size = LINE_SIZE;
 
 inline const char* inl_prefetch_n(const char* ptr, size_t n) 
 {
   while (n) {
     PREFETCH(ptr);
-    ptr += LINE_SIZE;
+    ptr += pf_line_size;
     n--;
   }
   return ptr;
@@ -37,7 +44,7 @@ inline char* inl_prefetchw_n(char* ptr, size_t n)
 {
   while (n) {
     PREFETCHW(ptr);
-    ptr += LINE_SIZE;
+    ptr += pf_line_size;
     n--;
   }
   return ptr;
@@ -58,7 +65,7 @@ inline const char* inl_prefetch_n_npf(const char* ptr, size_t n)
 {
   while (n) {
     //PREFETCH(p);
-    ptr += LINE_SIZE;
+    ptr += pf_line_size;
     n--;
   }
   return ptr;
@@ -68,7 +75,7 @@ inline char* inl_prefetchw_n_npf(char* ptr, size_t n)
 {
   while (n) {
     //PREFETCHW(p);
-    ptr += LINE_SIZE;
+    ptr += pf_line_size;
     n--;
   }
   return ptr;
@@ -107,8 +114,13 @@ private:
 };
 #endif
 
-constexpr inline size_t to_pf_line_count(size_t bytes) {
-  return ((bytes % LINE_SIZE) ? 1 : 0) + (bytes / LINE_SIZE);
+inline size_t to_pf_line_count(size_t bytes) {
+  return (bytes + pf_line_size - 1) / pf_line_size;
+}
+
+// Start of the line holding ptr, for ranges that are not line aligned
+inline const char* to_pf_line_base(const void* ptr) {
+  return reinterpret_cast<const char*>(reinterpret_cast<uintptr_t>(ptr) & ~(uintptr_t)(pf_line_size - 1));
 }
 
 #endif // #ifndef __PREFETCH1_H__
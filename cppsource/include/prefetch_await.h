@@ -0,0 +1,240 @@
+/**
+ * @file prefetch_await.h
+ * @brief Awaitables that issue a prefetch and give up the CPU, and a
+ * runner that switches between coroutines by symmetric transfer.
+ *
+ * With resumable, each suspension returns to the runner loop, which
+ * then resumes the next task. A symmetric_task instead hands control
+ * straight to the next task in the rotation from await_suspend, so a
+ * switch is one indirect jump when the compiler makes the transfer a
+ * tail call. It need not (GCC does not at -O0), and then each switch
+ * nests a call, so every SYMMETRIC_RETURN_SWITCHES switches the runner
+ * is returned to and resumes the next task itself, bounding the stack.
+ * Coroutines that should run under either
+ * runner suspend through coro_task_traits<TASK_T, PREFETCHER_T>::
+ * yield_type.
+ */
+#pragma once
+
+#ifndef SOURCES_RESUMABLE_H_
+#error This file requires <resumable.h>
+#endif
+
+#include <vector>
+#include <algorithm>
+#include <prefetch1.h>
+
+// Switches between returns to the runner loop; bounds the stack depth
+// when symmetric transfer is not a tail call
+#define SYMMETRIC_RETURN_SWITCHES 64
+
+/**
+ * @brief Prefetches n lines from ptr (if any), then suspends back to
+ * the runner, as suspend_always does
+ */
+template<typename PREFETCHER_T>
+struct prefetch_suspend {
+  explicit prefetch_suspend(const PREFETCHER_T&) {}
+  prefetch_suspend(const PREFETCHER_T& prefetcher, const void* ptr, size_t n) {
+    prefetcher.prefetch(static_cast<const char*>(ptr), n);
+  }
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(coroutine_handle<>) const noexcept {}
+  void await_resume() const noexcept {}
+};
+
+/**
+ * @brief The rotation of live symmetric tasks. next() is the whole cost
+ * of a switch; complete() (virtual, once per task) replaces or drops
+ * the slot of a finished task.
+ */
+class symmetric_scheduler {
+public:
+  virtual ~symmetric_scheduler() {}
+  coroutine_handle<> next() {
+    switches_++;
+    if (++pos_ == live_) {
+      pos_ = 0;
+    }
+    return transfer(ring_[pos_]);
+  }
+  virtual coroutine_handle<> complete() = 0;
+  // Switches in the last run
+  size_t switch_count() const { return switches_; }
+protected:
+  // The task to switch to; now and then, back to resume_from() instead
+  coroutine_handle<> transfer(coroutine_handle<> h) {
+    if (++since_return_ < SYMMETRIC_RETURN_SWITCHES) {
+      return h;
+    }
+    since_return_ = 0;
+    pending_ = h;
+    return noop_coroutine();
+  }
+  // Resumes h, and the tasks transfer() returns here, until all suspend
+  // to a noop_coroutine() with nothing pending
+  void resume_from(coroutine_handle<> h) {
+    since_return_ = 0;
+    pending_ = h;
+    while (pending_) {
+      h = pending_;
+      pending_ = nullptr;
+      h.resume();
+    }
+  }
+
+  std::vector<coroutine_handle<> > ring_;
+  size_t pos_ = 0;
+  size_t live_ = 0;
+  size_t switches_ = 0;
+  size_t since_return_ = 0;
+  coroutine_handle<> pending_ = nullptr;
+};
+
+/**
+ * @brief A coroutine that is owned by a symmetric_scheduler once
+ * started: its final suspension passes control to the next task
+ */
+struct symmetric_task {
+  struct promise_type : coro_frame_promise_base {
+    symmetric_scheduler* scheduler = nullptr;
+    symmetric_task get_return_object() {
+      return symmetric_task(coroutine_handle<promise_type>::from_promise(*this));
+    }
+    auto initial_suspend() noexcept {
+      return suspend_always { };
+    }
+    struct final_awaiter {
+      bool await_ready() const noexcept { return false; }
+      coroutine_handle<> await_suspend(coroutine_handle<promise_type> h) noexcept {
+        return h.promise().scheduler->complete();
+      }
+      void await_resume() const noexcept {}
+    };
+    auto final_suspend() noexcept {
+      return final_awaiter { };
+    }
+    void return_void() {}
+    void unhandled_exception() {
+      std::terminate();
+    }
+  };
+
+  explicit symmetric_task(coroutine_handle<promise_type> coroutine) : _coroutine(coroutine) {}
+  symmetric_task(symmetric_task const&) = delete;
+  symmetric_task& operator=(symmetric_task const&) = delete;
+  symmetric_task(symmetric_task&& other) noexcept : _coroutine(other._coroutine) {
+    other._coroutine = nullptr;
+  }
+  ~symmetric_task() {
+    if (_coroutine) {
+      _coroutine.destroy();
+    }
+  }
+  // Hands the frame over to a scheduler
+  coroutine_handle<promise_type> release(symmetric_scheduler* scheduler) {
+    coroutine_handle<promise_type> h = _coroutine;
+    _coroutine = nullptr;
+    h.promise().scheduler = scheduler;
+    return h;
+  }
+private:
+  coroutine_handle<promise_type> _coroutine;
+};
+
+/**
+ * @brief Prefetches n lines from ptr (if any), then transfers control
+ * to the next task in the rotation
+ */
+template<typename PREFETCHER_T>
+struct prefetch_awaitable {
+  explicit prefetch_awaitable(const PREFETCHER_T&) {}
+  prefetch_awaitable(const PREFETCHER_T& prefetcher, const void* ptr, size_t n) {
+    prefetcher.prefetch(static_cast<const char*>(ptr), n);
+  }
+  bool await_ready() const noexcept { return false; }
+  coroutine_handle<> await_suspend(coroutine_handle<symmetric_task::promise_type> h) const noexcept {
+    return h.promise().scheduler->next();
+  }
+  void await_resume() const noexcept {}
+};
+
+template<typename TASK_T, typename PREFETCHER_T>
+struct coro_task_traits {
+  typedef prefetch_suspend<PREFETCHER_T> yield_type;
+};
+
+template<typename PREFETCHER_T>
+struct coro_task_traits<symmetric_task, PREFETCHER_T> {
+  typedef prefetch_awaitable<PREFETCHER_T> yield_type;
+};
+
+/**
+ * @brief Same contract as coroutine_runner (run_coro.h) for
+ * symmetric tasks. run() resumes the first task and returns once the
+ * last one has finished.
+ */
+template<typename PREFETCHER_T, typename REFDATA_T>
+class coroutine_symmetric_runner : public symmetric_scheduler
+{
+public:
+  typedef symmetric_task (*coro_fn_t)(
+    const PREFETCHER_T &prefetcher,
+    REFDATA_T& refdata,
+    size_t coroutine_index);
+
+  coroutine_symmetric_runner(const PREFETCHER_T& prefetcher, REFDATA_T& refdata)
+  : prefetcher_(prefetcher), refdata_(refdata)
+  {
+  }
+
+  void run(size_t coroutine_count, size_t item_count, coro_fn_t coro_fn)
+  {
+    coro_fn_ = coro_fn;
+    item_count_ = item_count;
+    switches_ = 0;
+    live_ = std::min(coroutine_count, item_count);
+    ring_.resize(live_);
+    for (size_t b = 0; b < live_; b++)
+    {
+      ring_[b] = coro_fn_(prefetcher_, refdata_, b).release(this);
+    }
+    next_item_ = live_;
+    pos_ = 0;
+    if (live_ > 0)
+    {
+      resume_from(ring_[0]);
+    }
+  }
+
+  coroutine_handle<> complete() override
+  {
+    // The finished task is suspended at its final point, so may go
+    ring_[pos_].destroy();
+    if (next_item_ < item_count_)
+    {
+      ring_[pos_] = coro_fn_(prefetcher_, refdata_, next_item_).release(this);
+      next_item_++;
+      return next();
+    }
+    // Drop the slot: the last slot in the rotation takes its place
+    // and runs next
+    ring_[pos_] = ring_[--live_];
+    if (live_ == 0)
+    {
+      return noop_coroutine();
+    }
+    if (pos_ == live_)
+    {
+      pos_ = 0;
+    }
+    return transfer(ring_[pos_]);
+  }
+
+protected:
+  const PREFETCHER_T& prefetcher_;
+  REFDATA_T& refdata_;
+  coro_fn_t coro_fn_ = nullptr;
+  size_t item_count_ = 0;
+  size_t next_item_ = 0;
+};
@@ -18,13 +18,153 @@ using namespace std::experimental;
 #include <coroutine>
 #endif
 #include <exception>
+#include <cstddef>
+#include <new>
 
 using namespace std;
 
+/**
+ * Coroutine frame allocation. promise_type allocates every frame
+ * through the allocator installed on the current thread, or from the
+ * heap if there is none. A header in front of the frame records which
+ * allocator owns it, so a frame is always returned to its owner even
+ * if the installed allocator has since changed.
+ */
+class coro_frame_allocator {
+public:
+  virtual void* allocate(size_t size) = 0;
+  virtual void deallocate(void* p, size_t size) = 0;
+  virtual ~coro_frame_allocator() {}
+
+  static coro_frame_allocator*& current() {
+    thread_local coro_frame_allocator* allocator = nullptr;
+    return allocator;
+  }
+};
+
+/**
+ * Installs an allocator on the current thread for the lifetime of
+ * the scope
+ */
+class coro_frame_allocator_scope {
+public:
+  explicit coro_frame_allocator_scope(coro_frame_allocator* allocator)
+    : previous_(coro_frame_allocator::current()) {
+    coro_frame_allocator::current() = allocator;
+  }
+  ~coro_frame_allocator_scope() {
+    coro_frame_allocator::current() = previous_;
+  }
+private:
+  coro_frame_allocator* previous_;
+};
+
+/**
+ * Free lists of frames, one per frame size (each coroutine function
+ * has its own frame size). After warm-up, i.e. once the pool holds as
+ * many frames as are ever live at once, no frame touches the heap.
+ * Frames of more than POOL_SIZES distinct sizes go to the heap.
+ * Not thread safe: use one pool per thread.
+ */
+class coro_frame_pool : public coro_frame_allocator {
+public:
+  static constexpr size_t POOL_SIZES = 8;
+
+  coro_frame_pool() {}
+  coro_frame_pool(const coro_frame_pool&) = delete;
+  coro_frame_pool& operator=(const coro_frame_pool&) = delete;
+  ~coro_frame_pool() {
+    for (size_t i = 0; i < size_count_; i++) {
+      while (free_[i]) {
+        free_frame* f = free_[i];
+        free_[i] = f->next;
+        ::operator delete(f);
+      }
+    }
+  }
+
+  void* allocate(size_t size) override {
+    size_t i = find(size, true);
+    if (i < size_count_ && free_[i]) {
+      free_frame* f = free_[i];
+      free_[i] = f->next;
+      recycled_++;
+      return f;
+    }
+    created_++;
+    return ::operator new(size);
+  }
+  void deallocate(void* p, size_t size) override {
+    size_t i = find(size, false);
+    if (i < size_count_) {
+      free_frame* f = static_cast<free_frame*>(p);
+      f->next = free_[i];
+      free_[i] = f;
+    }
+    else {
+      ::operator delete(p);
+    }
+  }
+
+  // Frames taken from the heap, and frames served from a free list
+  size_t created() const { return created_; }
+  size_t recycled() const { return recycled_; }
+  void reset_counters() { created_ = recycled_ = 0; }
+
+private:
+  struct free_frame {
+    free_frame* next;
+  };
+  size_t find(size_t size, bool add) {
+    for (size_t i = 0; i < size_count_; i++) {
+      if (sizes_[i] == size) {
+        return i;
+      }
+    }
+    if (add && size_count_ < POOL_SIZES && size >= sizeof(free_frame)) {
+      sizes_[size_count_] = size;
+      free_[size_count_] = nullptr;
+      return size_count_++;
+    }
+    return POOL_SIZES;
+  }
+
+  size_t sizes_[POOL_SIZES];
+  free_frame* free_[POOL_SIZES];
+  size_t size_count_ = 0;
+  size_t created_ = 0;
+  size_t recycled_ = 0;
+};
+
+/**
+ * Base for promise types whose frames go through the installed
+ * coro_frame_allocator. The owning allocator (or nullptr for the heap)
+ * is kept in a header that preserves the alignment of the frame.
+ */
+struct coro_frame_promise_base {
+  static constexpr size_t HEADER_SIZE = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+  static void* operator new(size_t size) {
+    coro_frame_allocator* allocator = coro_frame_allocator::current();
+    void* p = allocator ? allocator->allocate(size + HEADER_SIZE) : ::operator new(size + HEADER_SIZE);
+    *static_cast<coro_frame_allocator**>(p) = allocator;
+    return static_cast<char*>(p) + HEADER_SIZE;
+  }
+  static void operator delete(void* frame, size_t size) {
+    void* p = static_cast<char*>(frame) - HEADER_SIZE;
+    coro_frame_allocator* allocator = *static_cast<coro_frame_allocator**>(p);
+    if (allocator) {
+      allocator->deallocate(p, size + HEADER_SIZE);
+    }
+    else {
+      ::operator delete(p);
+    }
+  }
+};
+
 namespace std {
 
 struct resumable {
-	struct promise_type {
+	struct promise_type : coro_frame_promise_base {
     bool is_complete;
     promise_type() : is_complete(false) {}
 		resumable get_return_object() {
@@ -54,6 +194,10 @@ struct resumable {
 	}
 	resumable& operator =(resumable&& other) noexcept {
 		if (&other != this) {
+			// Release our own frame, or it would leak (and never be recycled)
+			if (_coroutine) {
+				_coroutine.destroy();
+			}
 			_coroutine = other._coroutine;
 			other._coroutine = nullptr;
 		}
@@ -4,6 +4,9 @@
 #error This file requires <resumable.h>
 #endif
 
+#include <vector>
+#include <algorithm>
+
 template<typename PREFETCHER_T, typename REFDATA_T, typename RESUMABLE_T = resumable>
 class coroutine_runner
 {
@@ -20,6 +23,7 @@ public:
 
   void run(size_t coroutine_count, size_t item_count, coro_fn_t coro_fn)
   {
+    resumes_ = 0;
     // A collection of parallel tasks/coroutines
     std::vector<RESUMABLE_T> tasks;
     std::vector<bool> done(coroutine_count, false);
@@ -62,11 +66,122 @@ public:
         else
         {
           t.resume();
+          resumes_++;
         }
       }
     }
   }
+  // Resumptions in the last run
+  size_t resume_count() const { return resumes_; }
 protected:
   const PREFETCHER_T& prefetcher_;
   REFDATA_T& refdata_;
+  size_t resumes_ = 0;
+};
+
+// Same contract as coroutine_runner, but the live tasks sit in a 
+// fixed-capacity ring of slot indices. Each step pops a slot, resumes
+// it and pushes it back; a completed task is replaced in place by the
+// next item, or its slot leaves the ring when there are no more items.
+// Finished slots are never visited again.
+template<typename PREFETCHER_T, typename REFDATA_T, typename RESUMABLE_T = resumable>
+class coroutine_ring_runner
+{
+public:
+  typedef RESUMABLE_T (*coro_fn_t)(
+    const PREFETCHER_T &prefetcher, 
+    REFDATA_T& refdata,
+    size_t coroutine_index); 
+  
+  coroutine_ring_runner(const PREFETCHER_T& prefetcher, REFDATA_T& refdata)
+  : prefetcher_(prefetcher), refdata_(refdata)
+  {
+  }
+
+  void run(size_t coroutine_count, size_t item_count, coro_fn_t coro_fn)
+  {
+    count_source source { 0, item_count };
+    run_source(coroutine_count, source, coro_fn);
+  }
+
+  // As run(), but the items are those returned by source.next(item)
+  // until it returns false. A source that has complete(item) is told
+  // when each item's task finishes.
+  template<typename SOURCE_T>
+  void run_source(size_t coroutine_count, SOURCE_T& source, coro_fn_t coro_fn)
+  {
+    constexpr bool completes = requires(SOURCE_T& s, size_t i) { s.complete(i); };
+    resumes_ = 0;
+    tasks_.clear();
+    ring_.resize(coroutine_count);
+    if constexpr (completes)
+    {
+      items_.resize(coroutine_count);
+    }
+    size_t item;
+    size_t live = 0;
+    while (live < coroutine_count && source.next(item))
+    {
+      tasks_.push_back(coro_fn(prefetcher_, refdata_, item));
+      if constexpr (completes)
+      {
+        items_[live] = item;
+      }
+      ring_[live] = live;
+      live++;
+    }
+
+    size_t head = 0;
+    while (live > 0)
+    {
+      size_t c = ring_[head];
+      resumes_++;
+      if (!tasks_[c].resume())
+      {
+        if constexpr (completes)
+        {
+          source.complete(items_[c]);
+        }
+        if (!source.next(item))
+        {
+          // Drop the slot: the last slot in the rotation takes its place
+          // and runs next
+          ring_[head] = ring_[--live];
+          if (head == live)
+          {
+            head = 0;
+          }
+          continue;
+        }
+        tasks_[c] = coro_fn(prefetcher_, refdata_, item);
+        if constexpr (completes)
+        {
+          items_[c] = item;
+        }
+      }
+      head = (head + 1 == live) ? 0 : head + 1;
+    }
+  }
+  // Resumptions in the last run
+  size_t resume_count() const { return resumes_; }
+protected:
+  // Items next_ to end_ - 1, in order
+  struct count_source {
+    size_t next_;
+    size_t end_;
+    bool next(size_t& item) {
+      if (next_ == end_) {
+        return false;
+      }
+      item = next_++;
+      return true;
+    }
+  };
+
+  const PREFETCHER_T& prefetcher_;
+  REFDATA_T& refdata_;
+  std::vector<RESUMABLE_T> tasks_;
+  std::vector<size_t> ring_;
+  std::vector<size_t> items_; // Item of each task, for SOURCE_T::complete()
+  size_t resumes_ = 0;
 };
@@ -1,6 +1,9 @@
 #ifndef SVM_H
 #define SVM_H
 
+#include <cstddef>
+#include <cstdint>
+
 // #ifndef FPM_FIXED_HPP
 // #error svm.h requires fpm/fixed.hpp
 // #endif
@@ -13,11 +16,89 @@ template<>
 fix_t mult_op<fix_t>(const fix_t& x, const fix_t& y) { return fix_mul(x, y); }
 #endif // __FIXED_POINT_H__
 
+/**
+ * @brief Describes the raw integer representation of a fixed-point
+ * type, so that kernels can work on the underlying integers.
+ * 
+ * @tparam T an arithmetic type (no fractional places)
+ */
+template<typename T>
+struct svm_fixed_traits {
+  typedef T raw_t;
+  static constexpr unsigned int frac_bits = 0;
+  static raw_t raw(const T& v) { return v; }
+};
+
+#ifdef FPM_FIXED_HPP
+template<typename B, typename I, unsigned int F, bool R>
+struct svm_fixed_traits<fpm::fixed<B, I, F, R> > {
+  typedef B raw_t;
+  static constexpr unsigned int frac_bits = F;
+  static raw_t raw(const fpm::fixed<B, I, F, R>& v) { return v.raw_value(); }
+};
+#endif // FPM_FIXED_HPP
+
+#ifdef __FIXED_POINT_H__
+template<>
+struct svm_fixed_traits<fix_t> {
+  typedef fix_t raw_t;
+  static constexpr unsigned int frac_bits = FIX_FRAC_PLACES;
+  static raw_t raw(const fix_t& v) { return v; }
+};
+#endif // __FIXED_POINT_H__
+
+/**
+ * @brief Accumulator policy that sums the rescaled products in the
+ * data type itself. Each element pays a shift in mult_op, and the
+ * total wraps once it leaves the range of T.
+ */
+struct narrow_accumulator {
+  template<typename T> using total_t = T;
+  template<typename T>
+  static void add(T& total, const T& value, const T& weight) { total += mult_op(value, weight); }
+  template<typename T>
+  static bool exceeds(const T& total, const T& bias) { return total > bias; }
+  template<typename T>
+  static T margin(const T& total, const T& bias) { return total - bias; }
+};
 
 /**
- * @brief 
+ * @brief Accumulator policy that sums the raw integer products in
+ * ACC_T and compares against the bias, scaled into the product
+ * domain, once at the end. With ACC_T = int64_t the decision is exact
+ * for any practical spectrum length; with int32_t and Q3.13 data it is
+ * exact while the running sum stays within +/-32.0.
  * 
- * @tparam T 
+ * @tparam ACC_T a signed integer type wider than the raw data type
+ */
+template<typename ACC_T>
+struct wide_accumulator {
+  template<typename T> using total_t = ACC_T;
+  template<typename T>
+  static void add(ACC_T& total, const T& value, const T& weight)
+  {
+    typedef svm_fixed_traits<T> traits;
+    total += (ACC_T)traits::raw(value) * (ACC_T)traits::raw(weight);
+  }
+  template<typename T>
+  static bool exceeds(const ACC_T& total, const T& bias)
+  {
+    typedef svm_fixed_traits<T> traits;
+    return total > (ACC_T)traits::raw(bias) * ((ACC_T)1 << traits::frac_bits);
+  }
+  template<typename T>
+  static ACC_T margin(const ACC_T& total, const T& bias)
+  {
+    typedef svm_fixed_traits<T> traits;
+    return total - (ACC_T)traits::raw(bias) * ((ACC_T)1 << traits::frac_bits);
+  }
+};
+
+/**
+ * @brief Evaluates the linear SVM decision function w.x > bias
+ * 
+ * @tparam T data type of weights, values and bias
+ * @tparam ACC accumulator policy (narrow_accumulator or wide_accumulator)
  * @param weights 
  * @param values 
  * @param bias 
@@ -25,16 +106,106 @@ fix_t mult_op<fix_t>(const fix_t& x, const fix_t& y) { return fix_mul(x, y); }
  * @return true 
  * @return false 
  */
-template<typename T>
+template<typename T, typename ACC = narrow_accumulator>
 bool svm_infer(const T* weights, const T* values, T bias, size_t count)
 {
-  T total = T();
+  typename ACC::template total_t<T> total = {};
   for (size_t i = 0; i < count; i++, values++, weights++)
   {
-    // total += *values * *weights;
-    total += mult_op(*values, *weights);
+    ACC::add(total, *values, *weights);
+  }
+  return ACC::exceeds(total, bias);
+}
+
+/**
+ * @brief The largest number of sample rows scored in one pass by the
+ * blocked kernels
+ */
+#define SVM_MAX_BLOCK 8
+
+/**
+ * @brief Evaluates the decision function for several sample rows
+ * against one weight vector. Each weight is loaded once per block.
+ * 
+ * @tparam T data type of weights, values and bias
+ * @tparam ACC accumulator policy (narrow_accumulator or wide_accumulator)
+ * @param weights 
+ * @param values first of rows sample rows, each stride items apart
+ * @param stride distance between consecutive rows in items
+ * @param rows number of rows (1 to SVM_MAX_BLOCK)
+ * @param bias 
+ * @param count 
+ * @return uint32_t bit r is set if row r is classified as true
+ */
+template<typename T, typename ACC = narrow_accumulator>
+uint32_t svm_infer_block(const T* weights, const T* values, size_t stride, size_t rows, T bias, size_t count)
+{
+  typename ACC::template total_t<T> totals[SVM_MAX_BLOCK] = {};
+  for (size_t i = 0; i < count; i++)
+  {
+    const T& weight = weights[i];
+    const T* value = values + i;
+    for (size_t r = 0; r < rows; r++, value += stride)
+    {
+      ACC::add(totals[r], *value, weight);
+    }
+  }
+  uint32_t decisions = 0;
+  for (size_t r = 0; r < rows; r++)
+  {
+    if (ACC::exceeds(totals[r], bias))
+    {
+      decisions |= (1u << r);
+    }
+  }
+  return decisions;
+}
+
+/**
+ * @brief The largest number of classes in a one-vs-rest model bank
+ */
+#define SVM_MAX_CLASSES 16
+
+/**
+ * @brief Evaluates a one-vs-rest bank of linear SVMs in one pass over
+ * the sample, so each value is loaded once for all classifiers. Each
+ * row of the bank holds a bias followed by count weights.
+ * 
+ * @tparam T data type of weights, values and bias
+ * @tparam ACC accumulator policy (narrow_accumulator or wide_accumulator)
+ * @param bank first row of the model bank
+ * @param stride distance between consecutive bank rows in items
+ * @param classes number of rows in the bank (1 to SVM_MAX_CLASSES)
+ * @param values 
+ * @param count 
+ * @return size_t index of the class with the largest margin (ties go
+ * to the lowest index)
+ */
+template<typename T, typename ACC = narrow_accumulator>
+size_t svm_infer_argmax(const T* bank, size_t stride, size_t classes, const T* values, size_t count)
+{
+  typename ACC::template total_t<T> totals[SVM_MAX_CLASSES] = {};
+  for (size_t i = 0; i < count; i++)
+  {
+    const T& value = values[i];
+    const T* weight = bank + 1 + i;
+    for (size_t k = 0; k < classes; k++, weight += stride)
+    {
+      ACC::add(totals[k], value, *weight);
+    }
+  }
+  size_t best = 0;
+  auto best_margin = ACC::margin(totals[0], bank[0]);
+  for (size_t k = 1; k < classes; k++)
+  {
+    auto margin = ACC::margin(totals[k], bank[k * stride]);
+    if (margin > best_margin)
+    {
+      best = k;
+      best_margin = margin;
+    }
   }
-  return total > bias;
+  return best;
 }
 
 #endif // SVM_H
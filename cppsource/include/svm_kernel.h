@@ -0,0 +1,264 @@
+/**
+ * @file svm_kernel.h
+ * @brief Kernelised (RBF and polynomial) SVM decision functions in
+ * fixed point, built on the raw dot-product kernels of svm_simd.h.
+ *
+ * A model is a set of support vectors s_j with dual coefficients a_j
+ * (already multiplied by the class label) and a bias b, and the
+ * decision is sum_j a_j K(x, s_j) > b. All arithmetic is on the raw
+ * integers of the data type: no floating point is used after the
+ * lookup tables have been built.
+ */
+#ifndef SVM_KERNEL_H
+#define SVM_KERNEL_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <string>
+#include <stdexcept>
+
+#ifndef SVM_SIMD_H
+#error svm_kernel.h requires svm_simd.h
+#endif
+
+enum svm_kernel_type_t {
+  SVM_KERNEL_LINEAR = 0,
+  SVM_KERNEL_RBF,
+  SVM_KERNEL_POLY,
+
+  SVM_KERNEL_COUNT
+};
+
+inline const char* svm_kernel_name(svm_kernel_type_t type)
+{
+  static const char* names[] = { "linear", "rbf", "poly" };
+  return (type < SVM_KERNEL_COUNT) ? names[type] : "unknown";
+}
+
+/**
+ * @brief Converts a name to a kernel type
+ *
+ * @throws std::domain_error if the name is not recognised
+ */
+inline svm_kernel_type_t svm_kernel_from_name(const std::string& name)
+{
+  for (int i = 0; i < SVM_KERNEL_COUNT; i++)
+  {
+    if (name == svm_kernel_name((svm_kernel_type_t)i))
+    {
+      return (svm_kernel_type_t)i;
+    }
+  }
+  throw std::domain_error("unknown kernel '" + name + "'");
+}
+
+/**
+ * @brief Lookup-table evaluation of exp(-a) for a >= 0, where a and
+ * the result are raw fixed-point integers with FRAC_BITS fractional
+ * places. exp(-a) = exp(-n) * exp(-f) for the integer part n and the
+ * fraction f; exp(-f) is interpolated linearly between 2^INDEX_BITS
+ * table entries. The tables are held in Q2.30.
+ *
+ * @tparam FRAC_BITS fractional places of argument and result (>= 8)
+ */
+template<unsigned int FRAC_BITS>
+class fixed_neg_exp {
+public:
+  static_assert(FRAC_BITS >= 8 && FRAC_BITS <= 30, "fixed_neg_exp requires 8 to 30 fractional bits");
+  static constexpr unsigned int TABLE_BITS = 30;
+  static constexpr unsigned int INDEX_BITS = 8;
+  static constexpr unsigned int INT_ENTRIES = 32;
+
+  fixed_neg_exp()
+  {
+    for (unsigned int n = 0; n < INT_ENTRIES; n++)
+    {
+      int_table_[n] = (int64_t)std::llround(std::exp(-(double)n) * (double)(1LL << TABLE_BITS));
+    }
+    for (unsigned int i = 0; i <= (1u << INDEX_BITS); i++)
+    {
+      double f = (double)i / (double)(1u << INDEX_BITS);
+      frac_table_[i] = (int64_t)std::llround(std::exp(-f) * (double)(1LL << TABLE_BITS));
+    }
+  }
+
+  int64_t operator()(int64_t a) const
+  {
+    if (a <= 0)
+    {
+      return (int64_t)1 << FRAC_BITS;
+    }
+    int64_t n = a >> FRAC_BITS;
+    if (n >= (int64_t)INT_ENTRIES)
+    {
+      return 0;
+    }
+    constexpr unsigned int rem_bits = FRAC_BITS - INDEX_BITS;
+    int64_t f = a & (((int64_t)1 << FRAC_BITS) - 1);
+    int64_t index = f >> rem_bits;
+    int64_t rem = f & (((int64_t)1 << rem_bits) - 1);
+    int64_t e0 = frac_table_[index];
+    int64_t e1 = frac_table_[index + 1];
+    int64_t ef = e0 + (((e1 - e0) * rem) >> rem_bits);
+    return (int_table_[n] * ef) >> (2 * TABLE_BITS - FRAC_BITS);
+  }
+
+private:
+  int64_t int_table_[INT_ENTRIES];
+  int64_t frac_table_[(1u << INDEX_BITS) + 1];
+};
+
+/**
+ * @brief Kernel parameters, in the data type of the model
+ */
+template<typename T>
+struct svm_kernel_params {
+  svm_kernel_type_t type;
+  T gamma;
+  T coef0;
+  unsigned int degree;
+};
+
+/**
+ * @brief Evaluates kernel functions and decisions for a 16-bit
+ * fixed-point type. Inner products come from a raw dot kernel, and
+ * the RBF distance is expanded as |x|^2 + |s|^2 - 2 x.s so that it
+ * needs no kernel of its own; |s|^2 is precomputed per support vector
+ * and |x|^2 once per sample.
+ *
+ * Kernel values are raw integers with the fractional places of T;
+ * polynomial kernel values saturate at +/-2^31 raw.
+ *
+ * @tparam T a 16-bit fixed-point type
+ */
+template<typename T>
+class svm_kernel_evaluator {
+public:
+  typedef svm_fixed_traits<T> traits;
+  static constexpr unsigned int F = traits::frac_bits;
+  static_assert(sizeof(T) == sizeof(int16_t), "svm_kernel_evaluator requires a 16-bit data type");
+
+  svm_kernel_evaluator() : dot_(svm_dot_scalar), params_{SVM_KERNEL_LINEAR, T(), T(), 1} {}
+  svm_kernel_evaluator(const svm_kernel_params<T>& params, svm_dot_fn_t dot)
+    : dot_(dot ? dot : svm_dot_scalar), params_(params)
+  {
+  }
+
+  const svm_kernel_params<T>& params() const { return params_; }
+
+  /**
+   * @brief Squared norm of a sample or support vector, raw with 2F
+   * fractional places
+   */
+  int64_t norm(const T* v, size_t count) const
+  {
+    return dot_(raw(v), raw(v), count);
+  }
+
+  /**
+   * @brief K(x, s), raw with F fractional places
+   */
+  int64_t kernel(const T* x, int64_t x_norm, const T* sv, int64_t sv_norm, size_t count) const
+  {
+    int64_t xs = dot_(raw(x), raw(sv), count);
+    int64_t gamma = traits::raw(params_.gamma);
+    switch (params_.type)
+    {
+    case SVM_KERNEL_RBF:
+    {
+      int64_t dist = x_norm + sv_norm - 2 * xs;
+      return neg_exp_((gamma * dist) >> (2 * F));
+    }
+    case SVM_KERNEL_POLY:
+    {
+      int64_t u = ((gamma * xs) >> (2 * F)) + traits::raw(params_.coef0);
+      int64_t v = u;
+      for (unsigned int d = 1; d < params_.degree; d++)
+      {
+        v = std::clamp<int64_t>((v * u) >> F, INT32_MIN, INT32_MAX);
+      }
+      return v;
+    }
+    default:
+      return xs >> F;
+    }
+  }
+
+  /**
+   * @brief a_j K(x, s_j), raw with 2F fractional places, ready to be
+   * summed over the support vectors
+   */
+  static int64_t weighted(T alpha, int64_t k)
+  {
+    return (int64_t)traits::raw(alpha) * k;
+  }
+
+  static bool decide(int64_t total, T bias)
+  {
+    return total > svm_raw_threshold(bias);
+  }
+
+private:
+  static const int16_t* raw(const T* v) { return reinterpret_cast<const int16_t*>(v); }
+
+  svm_dot_fn_t dot_;
+  svm_kernel_params<T> params_;
+  fixed_neg_exp<F> neg_exp_;
+};
+
+/**
+ * @brief Adds the contribution of one support vector to the totals of
+ * several samples, so that a support vector can be streamed once for
+ * all the samples of a sensor.
+ *
+ * @param eval the kernel evaluator
+ * @param alpha dual coefficient of the support vector
+ * @param sv the support vector
+ * @param sv_norm |s|^2 (see norm())
+ * @param values first of rows sample rows, each stride items apart
+ * @param x_norms |x|^2 for each sample row
+ * @param rows number of sample rows
+ * @param stride distance between consecutive sample rows in items
+ * @param count
+ * @param totals running totals, one per sample row
+ */
+template<typename T>
+void svm_kernel_accumulate(const svm_kernel_evaluator<T>& eval, T alpha, const T* sv, int64_t sv_norm,
+  const T* values, const int64_t* x_norms, size_t rows, size_t stride, size_t count, int64_t* totals)
+{
+  for (size_t r = 0; r < rows; r++, values += stride)
+  {
+    totals[r] += eval.weighted(alpha, eval.kernel(values, x_norms[r], sv, sv_norm, count));
+  }
+}
+
+/**
+ * @brief Evaluates a kernel SVM for one sample. Each row of the model
+ * holds a dual coefficient followed by count support-vector items.
+ *
+ * @param eval the kernel evaluator
+ * @param model first row of the model
+ * @param stride distance between consecutive model rows in items
+ * @param sv_count number of support vectors
+ * @param sv_norms |s_j|^2 for each support vector (see norm())
+ * @param bias
+ * @param values
+ * @param count
+ * @return true if sum_j a_j K(x, s_j) > bias
+ */
+template<typename T>
+bool svm_kernel_infer(const svm_kernel_evaluator<T>& eval, const T* model, size_t stride,
+  size_t sv_count, const int64_t* sv_norms, T bias, const T* values, size_t count)
+{
+  int64_t x_norm = eval.norm(values, count);
+  int64_t total = 0;
+  for (size_t j = 0; j < sv_count; j++, model += stride)
+  {
+    total += eval.weighted(model[0], eval.kernel(values, x_norm, model + 1, sv_norms[j], count));
+  }
+  return eval.decide(total, bias);
+}
+
+#endif // SVM_KERNEL_H
@@ -0,0 +1,220 @@
+/**
+ * @file svm_quant.h
+ * @brief Int8 quantised weights for the linear SVM decision function,
+ * with int8 x int16 kernels built alongside those of svm_simd.h.
+ *
+ * Each weight vector (or bank of weight vectors) shares one scale s:
+ * w_raw ~= q * s / 2^SVM_Q8_SCALE_BITS with q in [-127, 127]. The
+ * kernels return the exact sum of q * x_raw, and the decision is made
+ * on sum * s against the bias shifted into the same domain, so no
+ * rounding happens after quantisation.
+ */
+#ifndef SVM_QUANT_H
+#define SVM_QUANT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+#ifndef SVM_SIMD_H
+#error svm_quant.h requires svm_simd.h
+#endif
+
+#define SVM_Q8_MAX 127
+#define SVM_Q8_SCALE_BITS 16
+
+/**
+ * @brief Signature of a raw int8 x int16 dot-product kernel
+ */
+typedef int64_t (*svm_dot_q8_fn_t)(const int8_t* w, const int16_t* x, size_t count);
+
+inline int64_t svm_dot_q8_scalar(const int8_t* w, const int16_t* x, size_t count)
+{
+  int64_t total = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    total += (int32_t)w[i] * (int32_t)x[i];
+  }
+  return total;
+}
+
+#ifdef SVM_SIMD_X86
+SVM_TARGET("sse4.1")
+inline int64_t svm_dot_q8_sse4(const int8_t* w, const int16_t* x, size_t count)
+{
+  // Sign-extend 8 weights to int16, then as svm_dot_sse4
+  __m128i acc0 = _mm_setzero_si128();
+  __m128i acc1 = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128i wv = _mm_cvtepi8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(w + i)));
+    __m128i xv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+    __m128i p = _mm_madd_epi16(wv, xv);
+    acc0 = _mm_add_epi64(acc0, _mm_cvtepi32_epi64(p));
+    acc1 = _mm_add_epi64(acc1, _mm_cvtepi32_epi64(_mm_srli_si128(p, 8)));
+  }
+  acc0 = _mm_add_epi64(acc0, acc1);
+  int64_t lanes[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc0);
+  return lanes[0] + lanes[1] + svm_dot_q8_scalar(w + i, x + i, count - i);
+}
+
+SVM_TARGET("avx2")
+inline int64_t svm_dot_q8_avx2(const int8_t* w, const int16_t* x, size_t count)
+{
+  __m256i acc0 = _mm256_setzero_si256();
+  __m256i acc1 = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    __m256i wv = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i)));
+    __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+    __m256i p = _mm256_madd_epi16(wv, xv);
+    acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(p)));
+    acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(p, 1)));
+  }
+  acc0 = _mm256_add_epi64(acc0, acc1);
+  int64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc0);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3]
+    + svm_dot_q8_scalar(w + i, x + i, count - i);
+}
+#endif // SVM_SIMD_X86
+
+#ifdef SVM_SIMD_NEON
+inline int64_t svm_dot_q8_neon(const int8_t* w, const int16_t* x, size_t count)
+{
+  int64x2_t acc = vdupq_n_s64(0);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    int16x8_t wv = vmovl_s8(vld1_s8(w + i));
+    int16x8_t xv = vld1q_s16(x + i);
+    int32x4_t p = vmull_s16(vget_low_s16(wv), vget_low_s16(xv));
+    p = vmlal_s16(p, vget_high_s16(wv), vget_high_s16(xv));
+    acc = vpadalq_s32(acc, p);
+  }
+  return vgetq_lane_s64(acc, 0) + vgetq_lane_s64(acc, 1)
+    + svm_dot_q8_scalar(w + i, x + i, count - i);
+}
+#endif // SVM_SIMD_NEON
+
+/**
+ * @brief Returns the int8 kernel for an ISA. SVM_ISA_GENERIC has no
+ * int8 template, so gets the scalar kernel.
+ */
+inline svm_dot_q8_fn_t svm_dot_q8_kernel(svm_isa_t isa)
+{
+  switch (isa)
+  {
+#ifdef SVM_SIMD_X86
+  case SVM_ISA_SSE4:
+    return svm_dot_q8_sse4;
+  case SVM_ISA_AVX2:
+    return svm_dot_q8_avx2;
+#endif
+#ifdef SVM_SIMD_NEON
+  case SVM_ISA_NEON:
+    return svm_dot_q8_neon;
+#endif
+  default:
+    return svm_dot_q8_scalar;
+  }
+}
+
+/**
+ * @brief Largest magnitude of the raw integers of a weight vector
+ */
+template<typename T>
+int32_t svm_max_abs_raw(const T* weights, size_t count)
+{
+  typedef svm_fixed_traits<T> traits;
+  int32_t m = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    m = std::max(m, std::abs((int32_t)traits::raw(weights[i])));
+  }
+  return m;
+}
+
+/**
+ * @brief Scale that maps a raw magnitude of max_abs onto SVM_Q8_MAX
+ */
+inline int64_t svm_q8_scale(int32_t max_abs)
+{
+  int64_t scale = (((int64_t)max_abs << SVM_Q8_SCALE_BITS) + SVM_Q8_MAX - 1) / SVM_Q8_MAX;
+  return std::max<int64_t>(scale, 1);
+}
+
+/**
+ * @brief Quantises weights to int8 with a scale from svm_q8_scale()
+ */
+template<typename T>
+void svm_quantize_q8(const T* weights, size_t count, int64_t scale, int8_t* q)
+{
+  typedef svm_fixed_traits<T> traits;
+  for (size_t i = 0; i < count; i++)
+  {
+    double v = std::nearbyint(std::ldexp((double)traits::raw(weights[i]), SVM_Q8_SCALE_BITS) / (double)scale);
+    q[i] = (int8_t)std::clamp<double>(v, -SVM_Q8_MAX, SVM_Q8_MAX);
+  }
+}
+
+/**
+ * @brief w.x - bias for int8 weights, in the product domain of the raw
+ * kernels multiplied by 2^SVM_Q8_SCALE_BITS
+ */
+template<typename T>
+inline int64_t svm_q8_margin(int64_t total, int64_t scale, T bias)
+{
+  return (total * scale) - (svm_raw_threshold(bias) << SVM_Q8_SCALE_BITS);
+}
+
+/**
+ * @brief Evaluates the linear decision function with int8 weights
+ *
+ * @tparam T a 16-bit fixed-point type
+ * @param dot the kernel returned by svm_dot_q8_kernel()
+ * @param scale the scale the weights were quantised with
+ * @return true if w.x > bias
+ */
+template<typename T>
+inline bool svm_infer_q8(svm_dot_q8_fn_t dot, const int8_t* weights, int64_t scale,
+  const T* values, T bias, size_t count)
+{
+  static_assert(sizeof(T) == sizeof(int16_t), "raw kernels require a 16-bit data type");
+  return svm_q8_margin(dot(weights, reinterpret_cast<const int16_t*>(values), count), scale, bias) > 0;
+}
+
+/**
+ * @brief Evaluates a one-vs-rest bank of int8 weight rows that share
+ * one scale
+ *
+ * @param bank first weight row; rows are stride items apart
+ * @param biases one bias per row
+ * @return size_t index of the class with the largest margin
+ */
+template<typename T>
+inline size_t svm_infer_q8_argmax(svm_dot_q8_fn_t dot, const int8_t* bank, size_t stride, int64_t scale,
+  const T* biases, size_t classes, const T* values, size_t count)
+{
+  static_assert(sizeof(T) == sizeof(int16_t), "raw kernels require a 16-bit data type");
+  const int16_t* x = reinterpret_cast<const int16_t*>(values);
+  size_t best = 0;
+  int64_t best_margin = svm_q8_margin(dot(bank, x, count), scale, biases[0]);
+  for (size_t k = 1; k < classes; k++)
+  {
+    int64_t margin = svm_q8_margin(dot(bank + k * stride, x, count), scale, biases[k]);
+    if (margin > best_margin)
+    {
+      best = k;
+      best_margin = margin;
+    }
+  }
+  return best;
+}
+
+#endif // SVM_QUANT_H
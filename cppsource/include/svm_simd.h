@@ -0,0 +1,638 @@
+/**
+ * @file svm_simd.h
+ * @brief Vectorised int16 x int16 -> int32 multiply-accumulate kernels
+ * for the linear SVM decision function, with a scalar fallback and a
+ * run-time ISA dispatcher.
+ *
+ * The kernels work on the raw 16-bit integers of a fixed-point type
+ * (e.g. Q3.13) and return the exact sum of the raw products, so the
+ * decision is made once against the bias shifted into the product
+ * domain. A pair of products can only wrap in 32 bits when both are
+ * (-32768 * -32768), i.e. -4.0 * -4.0 in Q3.13; every other input
+ * gives the same result on every ISA.
+ */
+#ifndef SVM_SIMD_H
+#define SVM_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include <cstdlib>
+
+#ifndef SVM_H
+#error svm_simd.h requires svm.h
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SVM_SIMD_X86 1
+#include <immintrin.h>
+#define SVM_TARGET(t) __attribute__((target(t)))
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SVM_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief Kernel families that can compute the decision function.
+ * SVM_ISA_GENERIC selects the svm_infer<T> template rather than one
+ * of the raw kernels below.
+ */
+enum svm_isa_t {
+  SVM_ISA_GENERIC = 0,
+  SVM_ISA_SCALAR,
+  SVM_ISA_SSE4,
+  SVM_ISA_AVX2,
+  SVM_ISA_NEON,
+
+  SVM_ISA_COUNT
+};
+
+/**
+ * @brief Signature of a raw dot-product kernel
+ */
+typedef int64_t (*svm_dot_fn_t)(const int16_t* w, const int16_t* x, size_t count);
+
+/**
+ * @brief Signature of a raw blocked kernel, which scores rows sample
+ * rows (stride items apart) against one weight vector and writes one
+ * total per row.
+ */
+typedef void (*svm_dot_block_fn_t)(const int16_t* w, const int16_t* x, size_t stride,
+  size_t rows, size_t count, int64_t* totals);
+
+/**
+ * @brief Splits a block of any height into calls to KERNEL_T::run<R>,
+ * where R is a compile-time row count of at most SVM_MAX_BLOCK, so
+ * that each row's accumulator can live in a register.
+ */
+template<typename KERNEL_T>
+inline void svm_dot_block(const int16_t* w, const int16_t* x, size_t stride,
+  size_t rows, size_t count, int64_t* totals)
+{
+  for (; rows >= SVM_MAX_BLOCK; rows -= SVM_MAX_BLOCK, x += SVM_MAX_BLOCK * stride, totals += SVM_MAX_BLOCK)
+  {
+    KERNEL_T::template run<SVM_MAX_BLOCK>(w, x, stride, count, totals);
+  }
+  switch (rows)
+  {
+  case 7: KERNEL_T::template run<7>(w, x, stride, count, totals); break;
+  case 6: KERNEL_T::template run<6>(w, x, stride, count, totals); break;
+  case 5: KERNEL_T::template run<5>(w, x, stride, count, totals); break;
+  case 4: KERNEL_T::template run<4>(w, x, stride, count, totals); break;
+  case 3: KERNEL_T::template run<3>(w, x, stride, count, totals); break;
+  case 2: KERNEL_T::template run<2>(w, x, stride, count, totals); break;
+  case 1: KERNEL_T::template run<1>(w, x, stride, count, totals); break;
+  default: break;
+  }
+}
+
+inline int64_t svm_dot_scalar(const int16_t* w, const int16_t* x, size_t count)
+{
+  int64_t total = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    total += (int32_t)w[i] * (int32_t)x[i];
+  }
+  return total;
+}
+
+struct svm_block_scalar {
+  template<size_t R>
+  static void run(const int16_t* w, const int16_t* x, size_t stride, size_t count, int64_t* totals)
+  {
+    int64_t acc[R] = {};
+    for (size_t i = 0; i < count; i++)
+    {
+      int32_t wi = w[i];
+      for (size_t r = 0; r < R; r++)
+      {
+        acc[r] += wi * (int32_t)x[r * stride + i];
+      }
+    }
+    for (size_t r = 0; r < R; r++)
+    {
+      totals[r] = acc[r];
+    }
+  }
+};
+
+#ifdef SVM_SIMD_X86
+SVM_TARGET("sse4.1")
+inline int64_t svm_dot_sse4(const int16_t* w, const int16_t* x, size_t count)
+{
+  // pmaddwd yields 4 pairwise int32 sums; widen them to int64 lanes
+  // each step so that long rows cannot overflow
+  __m128i acc0 = _mm_setzero_si128();
+  __m128i acc1 = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128i wv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i));
+    __m128i xv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+    __m128i p = _mm_madd_epi16(wv, xv);
+    acc0 = _mm_add_epi64(acc0, _mm_cvtepi32_epi64(p));
+    acc1 = _mm_add_epi64(acc1, _mm_cvtepi32_epi64(_mm_srli_si128(p, 8)));
+  }
+  acc0 = _mm_add_epi64(acc0, acc1);
+  int64_t lanes[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc0);
+  return lanes[0] + lanes[1] + svm_dot_scalar(w + i, x + i, count - i);
+}
+
+SVM_TARGET("avx2")
+inline int64_t svm_dot_avx2(const int16_t* w, const int16_t* x, size_t count)
+{
+  __m256i acc0 = _mm256_setzero_si256();
+  __m256i acc1 = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    __m256i wv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+    __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+    __m256i p = _mm256_madd_epi16(wv, xv);
+    acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(p)));
+    acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(p, 1)));
+  }
+  acc0 = _mm256_add_epi64(acc0, acc1);
+  int64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc0);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3]
+    + svm_dot_scalar(w + i, x + i, count - i);
+}
+
+struct svm_block_sse4 {
+  template<size_t R>
+  SVM_TARGET("sse4.1")
+  static void run(const int16_t* w, const int16_t* x, size_t stride, size_t count, int64_t* totals)
+  {
+    __m128i acc[R];
+    for (size_t r = 0; r < R; r++)
+    {
+      acc[r] = _mm_setzero_si128();
+    }
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+      __m128i wv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i));
+      for (size_t r = 0; r < R; r++)
+      {
+        __m128i xv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + r * stride + i));
+        __m128i p = _mm_madd_epi16(wv, xv);
+        acc[r] = _mm_add_epi64(acc[r], _mm_add_epi64(_mm_cvtepi32_epi64(p),
+          _mm_cvtepi32_epi64(_mm_srli_si128(p, 8))));
+      }
+    }
+    for (size_t r = 0; r < R; r++)
+    {
+      int64_t lanes[2];
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc[r]);
+      totals[r] = lanes[0] + lanes[1] + svm_dot_scalar(w + i, x + r * stride + i, count - i);
+    }
+  }
+};
+
+struct svm_block_avx2 {
+  template<size_t R>
+  SVM_TARGET("avx2")
+  static void run(const int16_t* w, const int16_t* x, size_t stride, size_t count, int64_t* totals)
+  {
+    __m256i acc[R];
+    for (size_t r = 0; r < R; r++)
+    {
+      acc[r] = _mm256_setzero_si256();
+    }
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+      __m256i wv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+      for (size_t r = 0; r < R; r++)
+      {
+        __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + r * stride + i));
+        __m256i p = _mm256_madd_epi16(wv, xv);
+        acc[r] = _mm256_add_epi64(acc[r], _mm256_add_epi64(
+          _mm256_cvtepi32_epi64(_mm256_castsi256_si128(p)),
+          _mm256_cvtepi32_epi64(_mm256_extracti128_si256(p, 1))));
+      }
+    }
+    for (size_t r = 0; r < R; r++)
+    {
+      int64_t lanes[4];
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc[r]);
+      totals[r] = lanes[0] + lanes[1] + lanes[2] + lanes[3]
+        + svm_dot_scalar(w + i, x + r * stride + i, count - i);
+    }
+  }
+};
+#endif // SVM_SIMD_X86
+
+#ifdef SVM_SIMD_NEON
+inline int64_t svm_dot_neon(const int16_t* w, const int16_t* x, size_t count)
+{
+  // vmull/vmlal accumulate a pair of products per int32 lane, which
+  // vpadal then folds into the int64 accumulator
+  int64x2_t acc = vdupq_n_s64(0);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    int16x8_t wv = vld1q_s16(w + i);
+    int16x8_t xv = vld1q_s16(x + i);
+    int32x4_t p = vmull_s16(vget_low_s16(wv), vget_low_s16(xv));
+    p = vmlal_s16(p, vget_high_s16(wv), vget_high_s16(xv));
+    acc = vpadalq_s32(acc, p);
+  }
+  return vgetq_lane_s64(acc, 0) + vgetq_lane_s64(acc, 1)
+    + svm_dot_scalar(w + i, x + i, count - i);
+}
+
+struct svm_block_neon {
+  template<size_t R>
+  static void run(const int16_t* w, const int16_t* x, size_t stride, size_t count, int64_t* totals)
+  {
+    int64x2_t acc[R];
+    for (size_t r = 0; r < R; r++)
+    {
+      acc[r] = vdupq_n_s64(0);
+    }
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+      int16x8_t wv = vld1q_s16(w + i);
+      int16x4_t wlo = vget_low_s16(wv);
+      int16x4_t whi = vget_high_s16(wv);
+      for (size_t r = 0; r < R; r++)
+      {
+        int16x8_t xv = vld1q_s16(x + r * stride + i);
+        int32x4_t p = vmull_s16(wlo, vget_low_s16(xv));
+        p = vmlal_s16(p, whi, vget_high_s16(xv));
+        acc[r] = vpadalq_s32(acc[r], p);
+      }
+    }
+    for (size_t r = 0; r < R; r++)
+    {
+      totals[r] = vgetq_lane_s64(acc[r], 0) + vgetq_lane_s64(acc[r], 1)
+        + svm_dot_scalar(w + i, x + r * stride + i, count - i);
+    }
+  }
+};
+#endif // SVM_SIMD_NEON
+
+inline const char* svm_isa_name(svm_isa_t isa)
+{
+  static const char* names[] = { "generic", "scalar", "sse4", "avx2", "neon" };
+  return (isa < SVM_ISA_COUNT) ? names[isa] : "unknown";
+}
+
+/**
+ * @brief Reports whether this build and this CPU can run the kernel
+ */
+inline bool svm_isa_supported(svm_isa_t isa)
+{
+  switch (isa)
+  {
+  case SVM_ISA_GENERIC:
+  case SVM_ISA_SCALAR:
+    return true;
+#ifdef SVM_SIMD_X86
+  case SVM_ISA_SSE4:
+    return __builtin_cpu_supports("sse4.1");
+  case SVM_ISA_AVX2:
+    return __builtin_cpu_supports("avx2");
+#endif
+#ifdef SVM_SIMD_NEON
+  case SVM_ISA_NEON:
+    return true;
+#endif
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief Picks the widest kernel supported by this CPU
+ */
+inline svm_isa_t svm_detect_isa()
+{
+  const svm_isa_t preferred[] = { SVM_ISA_AVX2, SVM_ISA_SSE4, SVM_ISA_NEON };
+  for (svm_isa_t isa : preferred)
+  {
+    if (svm_isa_supported(isa))
+    {
+      return isa;
+    }
+  }
+  return SVM_ISA_SCALAR;
+}
+
+/**
+ * @brief Converts a name to an ISA; "auto" selects the best one
+ * supported by this CPU.
+ *
+ * @throws std::domain_error if the name is not recognised
+ */
+inline svm_isa_t svm_isa_from_name(const std::string& name)
+{
+  if (name == "auto")
+  {
+    return svm_detect_isa();
+  }
+  for (int i = 0; i < SVM_ISA_COUNT; i++)
+  {
+    if (name == svm_isa_name((svm_isa_t)i))
+    {
+      return (svm_isa_t)i;
+    }
+  }
+  throw std::domain_error("unknown isa '" + name + "'");
+}
+
+/**
+ * @brief Returns the raw kernel for an ISA, or nullptr for
+ * SVM_ISA_GENERIC and for kernels not compiled into this build.
+ */
+inline svm_dot_fn_t svm_dot_kernel(svm_isa_t isa)
+{
+  switch (isa)
+  {
+  case SVM_ISA_SCALAR:
+    return svm_dot_scalar;
+#ifdef SVM_SIMD_X86
+  case SVM_ISA_SSE4:
+    return svm_dot_sse4;
+  case SVM_ISA_AVX2:
+    return svm_dot_avx2;
+#endif
+#ifdef SVM_SIMD_NEON
+  case SVM_ISA_NEON:
+    return svm_dot_neon;
+#endif
+  default:
+    return nullptr;
+  }
+}
+
+/**
+ * @brief Returns the raw blocked kernel for an ISA, or nullptr for
+ * SVM_ISA_GENERIC and for kernels not compiled into this build.
+ */
+inline svm_dot_block_fn_t svm_dot_block_kernel(svm_isa_t isa)
+{
+  switch (isa)
+  {
+  case SVM_ISA_SCALAR:
+    return svm_dot_block<svm_block_scalar>;
+#ifdef SVM_SIMD_X86
+  case SVM_ISA_SSE4:
+    return svm_dot_block<svm_block_sse4>;
+  case SVM_ISA_AVX2:
+    return svm_dot_block<svm_block_avx2>;
+#endif
+#ifdef SVM_SIMD_NEON
+  case SVM_ISA_NEON:
+    return svm_dot_block<svm_block_neon>;
+#endif
+  default:
+    return nullptr;
+  }
+}
+
+/**
+ * @brief Raw kernels with the count fixed at compile time, so that the
+ * compiler can unroll the main loop and resolve the tail statically.
+ * The count argument is ignored: use only for rows of exactly N items.
+ */
+template<size_t N>
+inline int64_t svm_dot_scalar_fixed(const int16_t* w, const int16_t* x, size_t)
+{
+  return svm_dot_scalar(w, x, N);
+}
+
+#ifdef SVM_SIMD_X86
+template<size_t N>
+SVM_TARGET("sse4.1")
+int64_t svm_dot_sse4_fixed(const int16_t* w, const int16_t* x, size_t)
+{
+  return svm_dot_sse4(w, x, N);
+}
+
+template<size_t N>
+SVM_TARGET("avx2")
+int64_t svm_dot_avx2_fixed(const int16_t* w, const int16_t* x, size_t)
+{
+  return svm_dot_avx2(w, x, N);
+}
+#endif // SVM_SIMD_X86
+
+#ifdef SVM_SIMD_NEON
+template<size_t N>
+int64_t svm_dot_neon_fixed(const int16_t* w, const int16_t* x, size_t)
+{
+  return svm_dot_neon(w, x, N);
+}
+#endif // SVM_SIMD_NEON
+
+/**
+ * @brief Returns the raw kernel for an ISA specialised for rows of N
+ * items, or nullptr as svm_dot_kernel()
+ */
+template<size_t N>
+inline svm_dot_fn_t svm_dot_fixed_kernel(svm_isa_t isa)
+{
+  switch (isa)
+  {
+  case SVM_ISA_SCALAR:
+    return svm_dot_scalar_fixed<N>;
+#ifdef SVM_SIMD_X86
+  case SVM_ISA_SSE4:
+    return svm_dot_sse4_fixed<N>;
+  case SVM_ISA_AVX2:
+    return svm_dot_avx2_fixed<N>;
+#endif
+#ifdef SVM_SIMD_NEON
+  case SVM_ISA_NEON:
+    return svm_dot_neon_fixed<N>;
+#endif
+  default:
+    return nullptr;
+  }
+}
+
+/**
+ * @brief Scales a bias into the product domain of the raw kernels
+ */
+template<typename T>
+inline int64_t svm_raw_threshold(T bias)
+{
+  typedef svm_fixed_traits<T> traits;
+  return (int64_t)traits::raw(bias) * ((int64_t)1 << traits::frac_bits);
+}
+
+/**
+ * @brief Evaluates the linear decision function with a raw kernel.
+ * The sum of products is compared against the bias scaled into the
+ * product domain, so no rescaling happens inside the loop.
+ *
+ * @tparam T a 16-bit fixed-point type
+ * @param dot the kernel returned by svm_dot_kernel()
+ * @return true if w.x > bias
+ */
+template<typename T>
+inline bool svm_infer_raw(svm_dot_fn_t dot, const T* weights, const T* values, T bias, size_t count)
+{
+  static_assert(sizeof(T) == sizeof(int16_t), "raw kernels require a 16-bit data type");
+  int64_t total = dot(reinterpret_cast<const int16_t*>(weights),
+    reinterpret_cast<const int16_t*>(values), count);
+  return total > svm_raw_threshold(bias);
+}
+
+/**
+ * @brief Evaluates the linear decision function for a block of sample
+ * rows with a raw blocked kernel.
+ *
+ * @tparam T a 16-bit fixed-point type
+ * @param dot_block the kernel returned by svm_dot_block_kernel()
+ * @return uint32_t bit r is set if row r is classified as true
+ */
+template<typename T>
+inline uint32_t svm_infer_raw_block(svm_dot_block_fn_t dot_block, const T* weights, const T* values,
+  size_t stride, size_t rows, T bias, size_t count)
+{
+  static_assert(sizeof(T) == sizeof(int16_t), "raw kernels require a 16-bit data type");
+  int64_t totals[SVM_MAX_BLOCK];
+  dot_block(reinterpret_cast<const int16_t*>(weights), reinterpret_cast<const int16_t*>(values),
+    stride, rows, count, totals);
+  int64_t threshold = svm_raw_threshold(bias);
+  uint32_t decisions = 0;
+  for (size_t r = 0; r < rows; r++)
+  {
+    if (totals[r] > threshold)
+    {
+      decisions |= (1u << r);
+    }
+  }
+  return decisions;
+}
+
+/**
+ * @brief Evaluates a one-vs-rest model bank with a raw blocked kernel.
+ * The sample plays the part of the weight vector and the bank rows the
+ * part of the sample rows, so the sample is loaded once per
+ * SVM_MAX_BLOCK classes.
+ *
+ * @tparam T a 16-bit fixed-point type
+ * @param dot_block the kernel returned by svm_dot_block_kernel()
+ * @param bank first row of the model bank; each row is a bias followed
+ * by count weights
+ * @param stride distance between consecutive bank rows in items
+ * @param classes number of rows in the bank (1 to SVM_MAX_CLASSES)
+ * @return size_t index of the class with the largest margin
+ */
+template<typename T>
+inline size_t svm_infer_raw_argmax(svm_dot_block_fn_t dot_block, const T* bank, size_t stride,
+  size_t classes, const T* values, size_t count)
+{
+  static_assert(sizeof(T) == sizeof(int16_t), "raw kernels require a 16-bit data type");
+  int64_t totals[SVM_MAX_CLASSES];
+  dot_block(reinterpret_cast<const int16_t*>(values), reinterpret_cast<const int16_t*>(bank + 1),
+    stride, classes, count, totals);
+  size_t best = 0;
+  int64_t best_margin = totals[0] - svm_raw_threshold(bank[0]);
+  for (size_t k = 1; k < classes; k++)
+  {
+    int64_t margin = totals[k] - svm_raw_threshold(bank[k * stride]);
+    if (margin > best_margin)
+    {
+      best = k;
+      best_margin = margin;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Orders the weights of one model by decreasing magnitude, so
+ * that the largest contributions to the decision come first.
+ *
+ * @param weights 
+ * @param count 
+ * @param order receives count indices; weights[order[0]] has the
+ * largest magnitude
+ */
+template<typename T, typename INDEX_T>
+void svm_magnitude_order(const T* weights, size_t count, INDEX_T* order)
+{
+  typedef svm_fixed_traits<T> traits;
+  std::iota(order, order + count, (INDEX_T)0);
+  std::stable_sort(order, order + count, [weights](INDEX_T a, INDEX_T b) {
+    return std::abs((int32_t)traits::raw(weights[a])) > std::abs((int32_t)traits::raw(weights[b]));
+  });
+}
+
+/**
+ * @brief Computes the suffix bounds used by svm_infer_raw_early_exit:
+ * bounds[c] = sum_{i >= c * chunk} |w_i| * x_max, in the raw product
+ * domain, for c = 0 .. ceil(count / chunk).
+ *
+ * @param x_bound bound on the magnitude of the raw integer of any
+ * sample value
+ * @param bounds receives ceil(count / chunk) + 1 entries
+ */
+template<typename T>
+void svm_suffix_bounds(const T* weights, size_t count, int64_t x_bound, size_t chunk, int64_t* bounds)
+{
+  typedef svm_fixed_traits<T> traits;
+  size_t chunks = (count + chunk - 1) / chunk;
+  bounds[chunks] = 0;
+  for (size_t c = chunks; c-- > 0; )
+  {
+    int64_t sum = 0;
+    for (size_t i = c * chunk; i < std::min(count, (c + 1) * chunk); i++)
+    {
+      sum += std::abs((int64_t)traits::raw(weights[i])) * x_bound;
+    }
+    bounds[c] = bounds[c + 1] + sum;
+  }
+}
+
+/**
+ * @brief Evaluates the linear decision function chunk by chunk, and
+ * stops as soon as the remaining chunks cannot change the decision.
+ * The weights should be in decreasing order of magnitude (see
+ * svm_magnitude_order) and values permuted to match. The decision is
+ * always the same as that of svm_infer_raw.
+ *
+ * @param dot the kernel returned by svm_dot_kernel()
+ * @param bounds suffix bounds from svm_suffix_bounds()
+ * @param chunk number of items between checks
+ * @param touched receives the number of items read
+ * @return true if w.x > bias
+ */
+template<typename T>
+inline bool svm_infer_raw_early_exit(svm_dot_fn_t dot, const T* weights, const T* values, T bias,
+  size_t count, const int64_t* bounds, size_t chunk, size_t& touched)
+{
+  static_assert(sizeof(T) == sizeof(int16_t), "raw kernels require a 16-bit data type");
+  const int16_t* w = reinterpret_cast<const int16_t*>(weights);
+  const int16_t* x = reinterpret_cast<const int16_t*>(values);
+  // margin = w.x - bias so far; the rest lies within +/-bounds[c]
+  int64_t margin = -svm_raw_threshold(bias);
+  size_t i = 0;
+  for (size_t c = 0; i < count; c++)
+  {
+    if (margin > bounds[c] || margin <= -bounds[c])
+    {
+      break;
+    }
+    size_t n = std::min(chunk, count - i);
+    margin += dot(w + i, x + i, n);
+    i += n;
+  }
+  touched = i;
+  return margin > 0;
+}
+
+#endif // SVM_SIMD_H
@@ -0,0 +1,118 @@
+/**
+ * @file svm_sparse.h
+ * @brief Band-compressed weights for the linear SVM decision function.
+ *
+ * Fault signatures in envelope spectra occupy a few frequency bands,
+ * so most weights are zero. A sparse model keeps only the bands of
+ * non-zero weights: a list of (start, length) runs and the weights of
+ * each run packed one after the other. Each run is scored with a raw
+ * dense kernel from svm_simd.h, so the sample is read only where the
+ * weights are non-zero and the reads stay contiguous.
+ */
+#ifndef SVM_SPARSE_H
+#define SVM_SPARSE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifndef SVM_SIMD_H
+#error svm_sparse.h requires svm_simd.h
+#endif
+
+// Zero runs shorter than this are kept inside a band, since a new band
+// costs more than a few multiplications by zero
+#define SVM_BAND_MIN_GAP 8
+
+struct svm_band_t {
+  uint16_t start;
+  uint16_t length;
+};
+
+/**
+ * @brief Finds the bands of non-zero weights and appends them, and
+ * their weights, to bands and values.
+ *
+ * @param min_gap shortest run of zeros that separates two bands
+ * @return size_t number of bands appended
+ */
+template<typename T>
+size_t svm_find_bands(const T* weights, size_t count, size_t min_gap,
+  std::vector<svm_band_t>& bands, std::vector<T>& values)
+{
+  typedef svm_fixed_traits<T> traits;
+  size_t found = 0;
+  size_t i = 0;
+  while (i < count)
+  {
+    if (traits::raw(weights[i]) == 0)
+    {
+      i++;
+      continue;
+    }
+    // Extend the band until min_gap zeros (or the end) follow it
+    size_t start = i;
+    size_t end = i + 1; // One past the last non-zero weight
+    for (i = end; i < count && i < end + min_gap; i++)
+    {
+      if (traits::raw(weights[i]) != 0)
+      {
+        end = i + 1;
+      }
+    }
+    bands.push_back({ (uint16_t)start, (uint16_t)(end - start) });
+    values.insert(values.end(), weights + start, weights + end);
+    found++;
+    i = end;
+  }
+  return found;
+}
+
+/**
+ * @brief Number of weights held by a list of bands
+ */
+inline size_t svm_band_items(const svm_band_t* bands, size_t band_count)
+{
+  size_t items = 0;
+  for (size_t b = 0; b < band_count; b++)
+  {
+    items += bands[b].length;
+  }
+  return items;
+}
+
+/**
+ * @brief Sum of products over the bands, in the raw product domain
+ *
+ * @param dot the kernel returned by svm_dot_kernel()
+ * @param values the packed weights of the bands
+ * @param x the whole (uncompressed) sample
+ */
+inline int64_t svm_dot_bands(svm_dot_fn_t dot, const svm_band_t* bands, size_t band_count,
+  const int16_t* values, const int16_t* x)
+{
+  int64_t total = 0;
+  for (size_t b = 0; b < band_count; b++)
+  {
+    total += dot(values, x + bands[b].start, bands[b].length);
+    values += bands[b].length;
+  }
+  return total;
+}
+
+/**
+ * @brief Evaluates the linear decision function with banded weights
+ *
+ * @tparam T a 16-bit fixed-point type
+ * @return true if w.x > bias
+ */
+template<typename T>
+inline bool svm_infer_bands(svm_dot_fn_t dot, const svm_band_t* bands, size_t band_count,
+  const T* values, const T* x, T bias)
+{
+  static_assert(sizeof(T) == sizeof(int16_t), "raw kernels require a 16-bit data type");
+  return svm_dot_bands(dot, bands, band_count, reinterpret_cast<const int16_t*>(values),
+    reinterpret_cast<const int16_t*>(x)) > svm_raw_threshold(bias);
+}
+
+#endif // SVM_SPARSE_H
@@ -0,0 +1,152 @@
+/**
+ * @file udp_batch.h
+ * @brief A bound UDP socket drained in batches with recvmmsg (Linux),
+ * into one preallocated slab of fixed-size slots.
+ *
+ * receive() blocks until at least one datagram is ready, then takes
+ * whatever else is queued, up to the batch size, in the same call.
+ * A datagram longer than the slot is truncated and flagged; the caller
+ * decides what a short or truncated datagram means. datagram_socket is
+ * the interface shared with the io_uring backend (uring_recv.h).
+ */
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+class datagram_socket {
+public:
+  virtual ~datagram_socket() {}
+  // Receives at least one datagram, or 0 after the timeout. The
+  // datagrams stay valid until the next call.
+  virtual size_t receive() = 0;
+  // Datagram i of the last receive()
+  virtual const char* data(size_t i) const = 0;
+  virtual size_t length(size_t i) const = 0;
+  virtual bool truncated(size_t i) const = 0;
+
+  virtual const char* backend_name() const = 0;
+  uint16_t port() const { return port_; }
+  uint64_t syscall_count() const { return syscalls_; }
+  uint64_t datagram_count() const { return datagrams_; }
+
+protected:
+  /**
+   * @brief Opens a UDP socket bound to port on all interfaces
+   *
+   * @param port to bind; 0 for any free port, as port() then shows
+   * @param timeout_ms receive timeout, if non-zero
+   * @param rcvbuf_bytes socket receive buffer to ask for, if non-zero
+   */
+  int open_socket(uint16_t port, int timeout_ms, size_t rcvbuf_bytes) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+      fail("socket", fd);
+    }
+    if (rcvbuf_bytes) {
+      int bytes = (int)rcvbuf_bytes;
+      // Past rmem_max only with CAP_NET_ADMIN; the plain request is capped
+      if (setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &bytes, sizeof(bytes)) != 0) {
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes));
+      }
+    }
+    if (timeout_ms) {
+      struct timeval tv = { timeout_ms / 1000, (timeout_ms % 1000) * 1000 };
+      setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    }
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+      fail("bind", fd);
+    }
+    socklen_t len = sizeof(addr);
+    getsockname(fd, (struct sockaddr*)&addr, &len);
+    port_ = ntohs(addr.sin_port);
+    return fd;
+  }
+  // Closes fd (if open) and throws, with errno's message
+  [[noreturn]] static void fail(const char* what, int fd) {
+    std::string message = std::string(what) + ": " + strerror(errno);
+    if (fd >= 0) {
+      close(fd);
+    }
+    throw std::runtime_error(message);
+  }
+
+  uint16_t port_ = 0;
+  uint64_t syscalls_ = 0;
+  uint64_t datagrams_ = 0;
+};
+
+class udp_batch_socket : public datagram_socket {
+public:
+  /**
+   * @param port to bind on all interfaces; 0 for any free port
+   * @param slot_size bytes per datagram slot
+   * @param batch datagrams per recvmmsg call at most
+   * @param timeout_ms a receive() with nothing ready returns 0 after this
+   * @param rcvbuf_bytes socket receive buffer to ask for, if non-zero
+   */
+  udp_batch_socket(uint16_t port, size_t slot_size, size_t batch, int timeout_ms,
+    size_t rcvbuf_bytes = 0)
+  : slot_size_(slot_size), slab_(slot_size * batch), iov_(batch), msgs_(batch)
+  {
+    fd_ = open_socket(port, timeout_ms, rcvbuf_bytes);
+    for (size_t i = 0; i < batch; i++) {
+      iov_[i].iov_base = slab_.data() + (i * slot_size_);
+      iov_[i].iov_len = slot_size_;
+      memset(&msgs_[i], 0, sizeof(msgs_[i]));
+      msgs_[i].msg_hdr.msg_iov = &iov_[i];
+      msgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+  }
+  udp_batch_socket(const udp_batch_socket&) = delete;
+  udp_batch_socket& operator=(const udp_batch_socket&) = delete;
+  ~udp_batch_socket() {
+    close(fd_);
+  }
+
+  // Receives up to the batch size of datagrams; 0 on timeout
+  size_t receive() override {
+    for (;;) {
+      syscalls_++;
+      int n = recvmmsg(fd_, msgs_.data(), (unsigned)msgs_.size(), MSG_WAITFORONE, nullptr);
+      if (n >= 0) {
+        datagrams_ += n;
+        return (size_t)n;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return 0;
+      }
+      if (errno != EINTR) {
+        fail("recvmmsg", -1);
+      }
+    }
+  }
+
+  const char* data(size_t i) const override { return slab_.data() + (i * slot_size_); }
+  size_t length(size_t i) const override { return msgs_[i].msg_len; }
+  bool truncated(size_t i) const override { return (msgs_[i].msg_hdr.msg_flags & MSG_TRUNC) != 0; }
+  const char* backend_name() const override { return "recvmmsg"; }
+
+private:
+  int fd_ = -1;
+  size_t slot_size_;
+  std::vector<char> slab_;
+  std::vector<struct iovec> iov_;
+  std::vector<struct mmsghdr> msgs_;
+};
@@ -0,0 +1,316 @@
+/**
+ * @file uring_recv.h
+ * @brief A bound UDP socket drained through io_uring: one multishot
+ * recvmsg fills datagram slots from a registered provided-buffer ring,
+ * and receive() reaps the completions in batches.
+ *
+ * While datagrams keep arriving there is no syscall per datagram, nor
+ * per batch: io_uring_enter is only called to wait when the completion
+ * queue is empty, and to re-arm the receive after the kernel has run
+ * out of slots. Slots handed out by receive() go back to the ring at the
+ * next call. Talks to the kernel directly (no liburing); needs Linux
+ * 6.0 or later. The constructor submits the receive, and throws
+ * std::runtime_error if io_uring is missing or disabled or rejects it
+ * (5.19 has the buffer ring but not multishot recvmsg), so the caller
+ * can fall back to recvmmsg.
+ */
+#pragma once
+
+#include <udp_batch.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <signal.h>
+#include <time.h>
+
+class uring_batch_socket : public datagram_socket {
+public:
+  /**
+   * @param port to bind on all interfaces; 0 for any free port
+   * @param slot_size bytes per datagram slot
+   * @param batch completions reaped per receive() at most
+   * @param timeout_ms a receive() with nothing ready returns 0 after this
+   * @param rcvbuf_bytes socket receive buffer to ask for, if non-zero
+   */
+  uring_batch_socket(uint16_t port, size_t slot_size, size_t batch, int timeout_ms,
+    size_t rcvbuf_bytes = 0)
+  : slot_size_(slot_size), buf_size_(sizeof(struct io_uring_recvmsg_out) + slot_size),
+    timeout_ms_(timeout_ms), batch_(batch)
+  {
+    // Enough slots for several batches in flight, as a power of two
+    buf_count_ = 64;
+    while (buf_count_ < 4 * batch && buf_count_ < 32768) {
+      buf_count_ *= 2;
+    }
+    fd_ = open_socket(port, 0, rcvbuf_bytes);
+    entries_.resize(batch_);
+    try {
+      setup();
+      arm();
+      submit();
+    } catch (...) {
+      teardown();
+      throw;
+    }
+  }
+  uring_batch_socket(const uring_batch_socket&) = delete;
+  uring_batch_socket& operator=(const uring_batch_socket&) = delete;
+  ~uring_batch_socket() {
+    teardown();
+  }
+
+  size_t receive() override {
+    recycle();
+    size_t n = reap();
+    while (n == 0) {
+      if (rearm_) {
+        arm();
+      }
+      struct __kernel_timespec ts = { timeout_ms_ / 1000, (timeout_ms_ % 1000) * 1000000ll };
+      struct io_uring_getevents_arg arg;
+      memset(&arg, 0, sizeof(arg));
+      arg.sigmask_sz = _NSIG / 8;
+      arg.ts = (uint64_t)(uintptr_t)&ts;
+      syscalls_++;
+      int ret = enter(to_submit_, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+      if (ret >= 0) {
+        to_submit_ = 0;
+      } else if (errno == ETIME) {
+        to_submit_ = 0;
+        return reap();
+      } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        fail("io_uring_enter", -1);
+      }
+      n = reap();
+    }
+    return n;
+  }
+
+  const char* data(size_t i) const override { return entries_[i].data; }
+  size_t length(size_t i) const override { return entries_[i].length; }
+  bool truncated(size_t i) const override { return entries_[i].truncated; }
+  const char* backend_name() const override { return "io_uring"; }
+
+private:
+  struct entry_t {
+    const char* data;
+    size_t length;
+    bool truncated;
+    uint16_t bid; // Slot, returned to the ring at the next receive()
+  };
+
+  int enter(unsigned to_submit, unsigned min_complete, unsigned flags, void* arg, size_t arg_size) {
+    return (int)syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, flags, arg, arg_size);
+  }
+
+  void setup() {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    p.flags = IORING_SETUP_CQSIZE;
+    p.cq_entries = 2 * buf_count_;
+    ring_fd_ = (int)syscall(__NR_io_uring_setup, 4, &p);
+    if (ring_fd_ < 0) {
+      fail("io_uring_setup", -1);
+    }
+    if (!(p.features & IORING_FEAT_SINGLE_MMAP) || !(p.features & IORING_FEAT_EXT_ARG)) {
+      errno = ENOSYS;
+      fail("io_uring features", -1);
+    }
+
+    // Submission and completion rings share one mapping
+    ring_bytes_ = std::max<size_t>(p.sq_off.array + p.sq_entries * sizeof(unsigned),
+      p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe));
+    ring_ = mmap(nullptr, ring_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (ring_ == MAP_FAILED) {
+      ring_ = nullptr;
+      fail("mmap rings", -1);
+    }
+    sqes_bytes_ = p.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(nullptr, sqes_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      fail("mmap sqes", -1);
+    }
+    sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+    char* base = static_cast<char*>(ring_);
+    sq_tail_ = reinterpret_cast<unsigned*>(base + p.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned*>(base + p.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(base + p.sq_off.array);
+    cq_head_ = reinterpret_cast<unsigned*>(base + p.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(base + p.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(base + p.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe*>(base + p.cq_off.cqes);
+
+    // The provided-buffer ring, and the slots it hands out
+    buf_ring_bytes_ = buf_count_ * sizeof(struct io_uring_buf);
+    void* buf_ring = mmap(nullptr, buf_ring_bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf_ring == MAP_FAILED) {
+      fail("mmap buffer ring", -1);
+    }
+    buf_ring_ = static_cast<struct io_uring_buf_ring*>(buf_ring);
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)buf_ring_;
+    reg.ring_entries = (uint32_t)buf_count_;
+    reg.bgid = BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+      fail("io_uring_register(PBUF_RING)", -1);
+    }
+    slab_.resize(buf_count_ * buf_size_);
+    for (size_t b = 0; b < buf_count_; b++) {
+      provide((uint16_t)b, b);
+    }
+    publish(buf_count_);
+
+    // Payload only: no source address, no control data
+    memset(&msg_, 0, sizeof(msg_));
+  }
+
+  void teardown() {
+    if (buf_ring_) {
+      munmap(buf_ring_, buf_ring_bytes_);
+      buf_ring_ = nullptr;
+    }
+    if (sqes_) {
+      munmap(sqes_, sqes_bytes_);
+      sqes_ = nullptr;
+    }
+    if (ring_) {
+      munmap(ring_, ring_bytes_);
+      ring_ = nullptr;
+    }
+    if (ring_fd_ >= 0) {
+      close(ring_fd_);
+      ring_fd_ = -1;
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  // Puts slot bid at position offset past the ring's tail. The ring is
+  // indexed as a plain array: in C++ the uapi header's flexible bufs[]
+  // member lands 8 bytes in, past the tail it should overlay
+  void provide(uint16_t bid, size_t offset) {
+    unsigned short tail = buf_ring_->tail;
+    struct io_uring_buf& buf = reinterpret_cast<struct io_uring_buf*>(buf_ring_)[(tail + offset) & (buf_count_ - 1)];
+    buf.addr = (uint64_t)(uintptr_t)(slab_.data() + (bid * buf_size_));
+    buf.len = (uint32_t)buf_size_;
+    buf.bid = bid;
+  }
+  void publish(size_t count) {
+    __atomic_store_n(&buf_ring_->tail, (unsigned short)(buf_ring_->tail + count), __ATOMIC_RELEASE);
+  }
+
+  // Returns the slots of the last batch to the kernel
+  void recycle() {
+    for (size_t i = 0; i < count_; i++) {
+      provide(entries_[i].bid, i);
+    }
+    publish(count_);
+    count_ = 0;
+  }
+
+  // Queues the multishot receive; submitted by the next io_uring_enter
+  void arm() {
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & sq_mask_;
+    struct io_uring_sqe* sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = fd_;
+    sqe->addr = (uint64_t)(uintptr_t)&msg_;
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    to_submit_++;
+    rearm_ = false;
+  }
+
+  // Submits the queued receive, and throws if the kernel refused it at
+  // once; any completion is left for reap()
+  void submit() {
+    if (enter(to_submit_, 0, 0, nullptr, 0) < 0) {
+      fail("io_uring_enter", -1);
+    }
+    to_submit_ = 0;
+    unsigned head = *cq_head_;
+    if (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+      const struct io_uring_cqe& cqe = cqes_[head & cq_mask_];
+      if (cqe.res < 0 && cqe.res != -ENOBUFS) {
+        errno = -cqe.res;
+        fail("multishot recvmsg", -1);
+      }
+    }
+  }
+
+  // Takes up to batch_ completions off the queue
+  size_t reap() {
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    size_t n = 0;
+    while (head != tail && n < batch_) {
+      const struct io_uring_cqe& cqe = cqes_[head & cq_mask_];
+      head++;
+      if (!(cqe.flags & IORING_CQE_F_MORE)) {
+        // The receive has stopped (out of slots, or an error)
+        rearm_ = true;
+      }
+      if (cqe.res < 0) {
+        if (cqe.res == -ENOBUFS) {
+          continue;
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        errno = -cqe.res;
+        fail("multishot recvmsg", -1);
+      }
+      if (!(cqe.flags & IORING_CQE_F_BUFFER)) {
+        continue;
+      }
+      uint16_t bid = (uint16_t)(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+      const char* slot = slab_.data() + (bid * buf_size_);
+      const struct io_uring_recvmsg_out* out = reinterpret_cast<const struct io_uring_recvmsg_out*>(slot);
+      bool truncated = (out->flags & MSG_TRUNC) != 0;
+      entries_[n++] = { slot + sizeof(*out) + out->namelen + out->controllen,
+        truncated ? slot_size_ : out->payloadlen, truncated, bid };
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    count_ = n;
+    datagrams_ += n;
+    return n;
+  }
+
+  static const uint16_t BUFFER_GROUP = 0;
+
+  int fd_ = -1;
+  int ring_fd_ = -1;
+  size_t slot_size_;
+  size_t buf_size_; // recvmsg header, then the payload
+  long timeout_ms_;
+  size_t batch_;
+  size_t buf_count_;
+  // Rings
+  void* ring_ = nullptr;
+  size_t ring_bytes_ = 0;
+  struct io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_bytes_ = 0;
+  unsigned* sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned* sq_array_ = nullptr;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  struct io_uring_cqe* cqes_ = nullptr;
+  struct io_uring_buf_ring* buf_ring_ = nullptr;
+  size_t buf_ring_bytes_ = 0;
+  std::vector<char> slab_;
+  struct msghdr msg_;
+  // State
+  unsigned to_submit_ = 0;
+  bool rearm_ = false;
+  std::vector<entry_t> entries_; // The last batch
+  size_t count_ = 0;
+};
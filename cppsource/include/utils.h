@@ -30,8 +30,8 @@ void dump_vector(const I& b, const I& e, std::ostream &os, std::string label = "
   os << " ]" << std::endl;
 }
 
-template <typename T>
-inline void dump_vector(const std::vector<T> &v, std::ostream &os, std::string label = "", size_t max_width = 64U)
+template <typename T, typename A>
+inline void dump_vector(const std::vector<T, A> &v, std::ostream &os, std::string label = "", size_t max_width = 64U)
 {
   dump_vector(v.begin(), v.end(), os, label, max_width);
 }
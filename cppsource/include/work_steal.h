@@ -0,0 +1,259 @@
+/**
+ * @file work_steal.h
+ * @brief Running one job on several pinned threads, with items shared
+ * out by work stealing.
+ *
+ * Each worker owns a contiguous range of items and takes them one at a
+ * time from the front. A worker whose range is empty steals the back
+ * half of another worker's range. Every range sits on its own cache
+ * line, so an owner taking items does not disturb its neighbours.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+#include <prefetch1.h>
+#if __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/**
+ * @brief Allocates whole, aligned cache lines, so that vectors written
+ * by different threads never share a line
+ */
+template<typename T>
+struct line_allocator {
+  typedef T value_type;
+  line_allocator() noexcept {}
+  template<typename U>
+  line_allocator(const line_allocator<U>&) noexcept {}
+  T* allocate(size_t n) {
+    size_t bytes = ((n * sizeof(T) + LINE_SIZE - 1) / LINE_SIZE) * LINE_SIZE;
+    return static_cast<T*>(::operator new(bytes, std::align_val_t(LINE_SIZE)));
+  }
+  void deallocate(T* p, size_t) noexcept {
+    ::operator delete(p, std::align_val_t(LINE_SIZE));
+  }
+  template<typename U>
+  bool operator==(const line_allocator<U>&) const noexcept { return true; }
+  template<typename U>
+  bool operator!=(const line_allocator<U>&) const noexcept { return false; }
+};
+
+/**
+ * @brief One range of items per worker; a range is [first, last)
+ * packed into one 64-bit word, so both ends change in one CAS
+ */
+class work_steal_ranges {
+public:
+  // Splits item_count items evenly over worker_count workers
+  void reset(size_t worker_count, size_t item_count) {
+    ranges_ = std::vector<range_t>(worker_count);
+    for (size_t w = 0; w < worker_count; w++) {
+      ranges_[w].span.store(pack((item_count * w) / worker_count,
+        (item_count * (w + 1)) / worker_count), std::memory_order_relaxed);
+    }
+    steals_.store(0, std::memory_order_relaxed);
+  }
+
+  // Takes the next item of the worker's own range
+  bool take(size_t worker, size_t& item) {
+    std::atomic<uint64_t>& span = ranges_[worker].span;
+    uint64_t s = span.load(std::memory_order_relaxed);
+    while (first(s) != last(s)) {
+      if (span.compare_exchange_weak(s, pack(first(s) + 1, last(s)), std::memory_order_acq_rel)) {
+        item = first(s);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Moves the back half of some other worker's range into the thief's
+  // (empty) range; false once every range is empty
+  bool steal(size_t thief) {
+    size_t count = ranges_.size();
+    for (size_t i = 1; i < count; i++) {
+      std::atomic<uint64_t>& span = ranges_[(thief + i) % count].span;
+      uint64_t s = span.load(std::memory_order_relaxed);
+      while (first(s) != last(s)) {
+        uint64_t half = (last(s) - first(s) + 1) / 2;
+        if (span.compare_exchange_weak(s, pack(first(s), last(s) - half), std::memory_order_acq_rel)) {
+          ranges_[thief].span.store(pack(last(s) - half, last(s)), std::memory_order_release);
+          steals_.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  // Steals in the last run
+  size_t steal_count() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+  struct alignas(LINE_SIZE) range_t {
+    std::atomic<uint64_t> span { 0 };
+  };
+  static uint64_t pack(uint64_t first, uint64_t last) { return (last << 32) | first; }
+  static uint64_t first(uint64_t s) { return s & 0xffffffffu; }
+  static uint64_t last(uint64_t s) { return s >> 32; }
+
+  std::vector<range_t> ranges_;
+  std::atomic<size_t> steals_ { 0 };
+};
+
+/**
+ * @brief The items of one worker, for coroutine_ring_runner::run_source()
+ */
+class work_steal_source {
+public:
+  work_steal_source(work_steal_ranges& ranges, size_t worker)
+  : ranges_(ranges), worker_(worker)
+  {
+  }
+  bool next(size_t& item) {
+    while (!ranges_.take(worker_, item)) {
+      if (!ranges_.steal(worker_)) {
+        return false;
+      }
+    }
+    return true;
+  }
+private:
+  work_steal_ranges& ranges_;
+  size_t worker_;
+};
+
+/**
+ * @brief A fixed set of worker threads, each pinned to one CPU. The
+ * calling thread is worker 0, so a pool of one has no extra threads; it
+ * is pinned only while run() is in progress and then gets its own
+ * affinity back. Workers sleep between jobs.
+ */
+class worker_pool {
+public:
+  typedef std::function<void(size_t worker)> job_t;
+
+  explicit worker_pool(size_t worker_count)
+  : worker_count_(worker_count)
+  {
+    for (size_t w = 1; w < worker_count_; w++) {
+      threads_.emplace_back([this, w]() { work(w); });
+    }
+  }
+  worker_pool(const worker_pool&) = delete;
+  worker_pool& operator=(const worker_pool&) = delete;
+  ~worker_pool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+      generation_++;
+    }
+    wake_.notify_all();
+    for (auto& t : threads_) {
+      t.join();
+    }
+  }
+
+  size_t size() const { return worker_count_; }
+
+  // Runs job on workers 0 to active - 1 and returns once all are done
+  void run(size_t active, const job_t& job) {
+    active = std::min(std::max<size_t>(active, 1), worker_count_);
+    pending_.store(active - 1, std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job_ = &job;
+      active_ = active;
+      generation_++;
+    }
+    wake_.notify_all();
+    pinned_caller caller;
+    job(0);
+    while (pending_.load(std::memory_order_acquire) != 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Pins the calling thread to cpu (modulo the CPUs present)
+  static bool pin_current_thread(size_t cpu) {
+#if __linux__
+    unsigned cpus = std::max(std::thread::hardware_concurrency(), 1u);
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % cpus, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+  }
+
+private:
+  // Pins the calling thread as worker 0 for its lifetime, then restores
+  // the affinity it had before
+  class pinned_caller {
+  public:
+    pinned_caller() {
+#if __linux__
+      saved_ = pthread_getaffinity_np(pthread_self(), sizeof(cpus_), &cpus_) == 0;
+#endif
+      pin_current_thread(0);
+    }
+    pinned_caller(const pinned_caller&) = delete;
+    pinned_caller& operator=(const pinned_caller&) = delete;
+    ~pinned_caller() {
+#if __linux__
+      if (saved_) {
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus_), &cpus_);
+      }
+#endif
+    }
+  private:
+#if __linux__
+    cpu_set_t cpus_;
+    bool saved_ = false;
+#endif
+  };
+
+  void work(size_t worker) {
+    pin_current_thread(worker);
+    uint64_t seen = 0;
+    for (;;) {
+      const job_t* job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [&]() { return generation_ != seen; });
+        seen = generation_;
+        if (stopping_) {
+          return;
+        }
+        if (worker >= active_) {
+          continue;
+        }
+        job = job_;
+      }
+      (*job)(worker);
+      pending_.fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+  size_t worker_count_;
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  uint64_t generation_ = 0;
+  bool stopping_ = false;
+  const job_t* job_ = nullptr;
+  size_t active_ = 0;
+  alignas(LINE_SIZE) std::atomic<size_t> pending_ { 0 };
+};
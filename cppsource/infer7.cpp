@@ -12,6 +12,10 @@
 
 #include <tclap/CmdLine.h>
 #include <svm.h>
+#include <svm_simd.h>
+#include <svm_kernel.h>
+#include <svm_quant.h>
+#include <svm_sparse.h>
 // #include <common.h>
 #include <vector>
 #include <iostream>
@@ -20,6 +24,8 @@
 #include <gpio.h>
 #include <timer.h>
 #include <memory>
+#include <atomic>
+#include <thread>
 
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -30,7 +36,8 @@
 #include <netinet/in.h>
 #include <netinet/udp.h>
 
-#define TLX_BTREE_FRIENDS friend class btree_accessor
+class btree_accessor;
+#define TLX_BTREE_FRIENDS friend class ::btree_accessor
 #include <tlx/container/btree.hpp>
 #include <tlx/container/btree_map.hpp>
 #include <uuid.h>
@@ -46,8 +53,18 @@
 #include <resumable.h>
 #include <prefetch1.h>
 #include <bounded_random.h>
+#include <work_steal.h>
+#include <autotune.h>
+#include <cache_topology.h>
+#include <deadline_sched.h>
+#include <udp_batch.h>
+#include <uring_recv.h>
+#include <capture.h>
+#include <load_gen.h>
+#include <commands.h>
 #ifdef USE_GENERIC_COROUTINE_RUNNER
 #include <run_coro.h>
+#include <prefetch_await.h>
 #endif
 
 #ifndef MEASURE_LOCALITY
@@ -87,26 +104,135 @@ struct datagram_t
   data_item_t data[2];
 };
 
-inline uint32_t svm_len_from_datagram_bytes(uint32_t datagram_size)
+constexpr uint32_t svm_len_from_datagram_bytes(uint32_t datagram_size)
 {
   // there are also 2 items in the header
   return ((datagram_size - sizeof(datagram_t)) / sizeof(data_item_t)) + 2; 
 }
 
 typedef int result_t;
+// Each sensor's results start on a line of their own, so threads that
+// score different sensors never write to the same line
+typedef std::vector<result_t, line_allocator<result_t> > result_vector_t;
 
 #define MIN_SV_LEN 2
 #define XSTR(s) STR(s)
 #define STR(s) #s
 
+/**
+ * @brief Looks up a raw kernel specialised for the support-vector 
+ * length of one of the datagram sizes we deploy
+ *
+ * @return the kernel, or nullptr if sv_len has no specialisation
+ */
+svm_dot_fn_t svm_dot_kernel_for_length(svm_isa_t isa, uint32_t sv_len)
+{
+  switch (sv_len)
+  {
+  case svm_len_from_datagram_bytes(512):
+    return svm_dot_fixed_kernel<svm_len_from_datagram_bytes(512)>(isa);
+  case svm_len_from_datagram_bytes(1024):
+    return svm_dot_fixed_kernel<svm_len_from_datagram_bytes(1024)>(isa);
+  case svm_len_from_datagram_bytes(2048):
+    return svm_dot_fixed_kernel<svm_len_from_datagram_bytes(2048)>(isa);
+  default:
+    return nullptr;
+  }
+}
+
 // Execution models and patterns for selecting model
 #define EXEC_MODEL_SEQ 0
 #define EXEC_MODEL_CORO 1
+#define EXEC_MODEL_SYMMETRIC 2 // Coroutines switching by symmetric transfer
+#define EXEC_MODEL_THREADS 3 // A ring of coroutines on each of several threads
+#define EXEC_MODEL_AMAC 4 // Asynchronous memory access chaining: explicit state machines
+#define EXEC_MODEL_PIPELINED 5 // Sequential, with prefetches a fixed distance ahead
+#define EXEC_MODEL_DEADLINE 6 // Coroutines launched earliest deadline first
+
+// Models that can be compared against the sequential model
+const char *exec_model_names[] = {
+    "seq",
+    "coro",
+    "symmetric",
+    "threads",
+    "amac",
+    "pipelined",
+    "deadline",
+    0};
+
+// Auto-tuner: candidate task counts, and the sensors scored by each
+// calibration slice
+const std::vector<uint16_t> autotune_task_counts = { 1, 2, 3, 4, 6, 8, 12, 16, 24, 32 };
+#define AUTOTUNE_SLICE_SENSORS 256
+
+// Most bytes a coroutine prefetches before suspending, when sized from
+// the caches: a page, beyond which the hardware prefetcher does not
+// follow a sequential burst
+#define SUSPEND_MAX_BYTES 4096
+
+// There are two GPIO pins: sequential and interleaved models
+#define GPIO_PIN(exec_model) (((exec_model) == EXEC_MODEL_SEQ) ? 0 : 1)
 
 #define EXEC_PATTERN_SEQ 0
 #define EXEC_PATTERN_CORO 1
 #define EXEC_PATTERN_BOTH 2
 
+// Coroutine runners (see run_coro.h)
+#define RUNNER_POLL 0
+#define RUNNER_RING 1
+
+const char *runner_names[] = {
+    "poll",
+    "ring",
+    0};
+
+// Accumulators for the decision function
+#define ACCUM_NARROW 0
+#define ACCUM_WIDE32 1
+#define ACCUM_WIDE64 2
+
+const char *accumulator_names[] = {
+    "narrow",
+    "wide32",
+    "wide64",
+    0};
+
+// Storage formats for the weights
+#define WEIGHTS_INT16 0
+#define WEIGHTS_INT8 1
+#define WEIGHTS_SPARSE 2 // Every sensor banded
+#define WEIGHTS_AUTO 3 // Banded where dense enough, else int16
+
+const char *weights_format_names[] = {
+    "int16",
+    "int8",
+    "sparse",
+    "auto",
+    0};
+
+// UDP receive backends (-p)
+#define RECV_BACKEND_AUTO 0 // io_uring if the kernel allows it, else recvmmsg
+#define RECV_BACKEND_IO_URING 1
+#define RECV_BACKEND_RECVMMSG 2
+
+const char *recv_backend_names[] = {
+    "auto",
+    "io_uring",
+    "recvmmsg",
+    0};
+
+// Arrival processes for --rate (load_gen.h)
+const char *arrivals_names[] = {
+    "fixed",
+    "poisson",
+    0};
+
+// Sensors whose non-zero weights cover no more than this fraction of
+// the bins are banded by WEIGHTS_AUTO
+#define SPARSE_MAX_DENSITY 0.5f
+// Bands per simulated model when weights_density < 1
+#define SIM_WEIGHT_BANDS 3
+
 ////////////////////////////////////////////////////////////////
 // Trace helper
 ////////////////////////////////////////////////////////////////
@@ -139,11 +265,14 @@ typedef uint16_t clear_cache_t;
 // from optimising out the whole of clear_cache()
 std::vector<std::vector<clear_cache_t>> cached_buf;
 
+// Bytes written by clear_cache(); set from the last level cache size
+size_t clear_cache_bytes = 128 * 1024 * 1024;
+
 void clear_cache()
 {
   std::vector<std::vector<clear_cache_t>> &buf = cached_buf;
-  size_t outer = 64000;
   size_t inner = 1000;
+  size_t outer = clear_cache_bytes / (inner * sizeof(clear_cache_t));
   for (size_t i = 0; i < outer; i++)
   {
     std::vector<clear_cache_t> inner_buf(inner);
@@ -160,23 +289,59 @@ void clear_cache()
 // Input simulator
 ////////////////////////////////////////////////////////////////
 
+// Where a datagram's payload belongs: the row its validated header
+// names, or nullptr if the header is not valid (see place_next_input)
+class input_placer {
+public:
+  virtual data_item_t* place(const datagram_t& header)=0;
+  virtual size_t row_length() const=0; // Items
+  virtual ~input_placer() {}
+};
+
 class input_receiver {
 public:
   virtual bool get_next_input(std::vector<data_item_t>& buffer)=0;
+  // As get_next_input(), but the payload is written once, into the row
+  // placer gives for the header; placed is false if there was none.
+  // Receivers that can see the header before the payload override this;
+  // the default stages the datagram and copies it.
+  virtual bool place_next_input(input_placer& placer, bool& placed)
+  {
+    if (!get_next_input(staging_))
+    {
+      return false;
+    }
+    const datagram_t* pdata = reinterpret_cast<const datagram_t*>(staging_.data());
+    data_item_t* row = placer.place(*pdata);
+    placed = (row != nullptr);
+    if (row)
+    {
+      std::copy(pdata->data, pdata->data + placer.row_length(), row);
+    }
+    return true;
+  }
   virtual void reset()=0;
   virtual bool stop_requested() const=0;
+  // True once if the source has asked for an EXEC_PATTERN_ since the last call
+  virtual bool pattern_requested(int& pattern) { (void)pattern; return false; }
+  // Whether datagrams may be lost, so that a sequence gap is not fatal
+  virtual bool lossy() const { return false; }
   virtual ~input_receiver() {}
+protected:
+  std::vector<data_item_t> staging_;
 };
 
 class input_simulator : public input_receiver {
 public:
+  // If bin_order is given, each sensor transmits its bins in the
+  // order of its weights (see runtime_data::initialise_early_exit)
   input_simulator(const std::vector<bpt_key_t>& sensor_ids, 
     uint32_t sample_count, uint32_t datagram_size,
-    rnd_bounds bounds)
+    rnd_bounds bounds, const std::vector<uint16_t>* bin_order = nullptr)
     : sensor_ids_(sensor_ids), sample_count_(sample_count),
       datagram_size_(datagram_size), 
       svm_len_(svm_len_from_datagram_bytes(datagram_size_)),
-      distribution_(bounds)
+      distribution_(bounds), bin_order_(bin_order)
   {
     sensor_indices_.resize(sensor_ids_.size());
     std::iota(sensor_indices_.begin(), sensor_indices_.end(), 0);
@@ -195,20 +360,13 @@ public:
   }
   virtual bool get_next_input(std::vector<data_item_t>& buffer)
   {
-    if (current_sensor_index_index_ == sensor_ids_.size())
-    {
-      current_sensor_index_index_ = 0;
-      current_seq_id_++;
-      std::shuffle(sensor_indices_.begin(), sensor_indices_.end(), shuffler_);
-    }
-    if (current_seq_id_ == sample_count_)
+    // Identify source
+    uint32_t current_sensor_index;
+    if (!next_sensor(current_sensor_index))
     {
       return false;
     }
 
-    // Identify source
-    uint32_t current_sensor_index = sensor_indices_[current_sensor_index_index_];
-
     // Prepare buffer
     buffer.resize(datagram_size_ / sizeof(data_item_t));
     datagram_t* pdata = (datagram_t*)buffer.data();
@@ -218,15 +376,69 @@ public:
     pdata->seq_id = current_seq_id_;
     
     // Fill data
-    auto rand_ampl = [&]() { return distribution_(engine_); };
-    std::generate(pdata->data, pdata->data + svm_len_, rand_ampl);
-
-    // Move to next record...
-    current_sensor_index_index_++;
+    fill_amplitudes(current_sensor_index, pdata->data);
+    return true;
+  }
+  // The header is resolved to a row first, and the spectrum generated
+  // straight into it; into scratch if the header is rejected, so the
+  // random stream stays the same
+  virtual bool place_next_input(input_placer& placer, bool& placed)
+  {
+    uint32_t current_sensor_index;
+    if (!next_sensor(current_sensor_index))
+    {
+      return false;
+    }
+    header_.sensor_id = sensor_ids_[current_sensor_index];
+    header_.seq_id = current_seq_id_;
+    data_item_t* row = placer.place(header_);
+    placed = (row != nullptr);
+    if (!row)
+    {
+      payload_.resize(svm_len_);
+      row = payload_.data();
+    }
+    fill_amplitudes(current_sensor_index, row);
     return true;
   }
   virtual bool stop_requested() const { return false; }
 private:
+  // Moves to the next record: every sensor once per sequence ID, in a
+  // new order each time; false once the period is complete
+  bool next_sensor(uint32_t& sensor_index)
+  {
+    if (current_sensor_index_index_ == sensor_ids_.size())
+    {
+      current_sensor_index_index_ = 0;
+      current_seq_id_++;
+      std::shuffle(sensor_indices_.begin(), sensor_indices_.end(), shuffler_);
+    }
+    if (current_seq_id_ == sample_count_)
+    {
+      return false;
+    }
+    sensor_index = sensor_indices_[current_sensor_index_index_++];
+    return true;
+  }
+  void fill_amplitudes(uint32_t sensor_index, data_item_t* data)
+  {
+    auto rand_ampl = [&]() { return distribution_(engine_); };
+    if (bin_order_)
+    {
+      spectrum_.resize(svm_len_);
+      std::generate(spectrum_.begin(), spectrum_.end(), rand_ampl);
+      const uint16_t* order = bin_order_->data() + ((size_t)svm_len_ * sensor_index);
+      for (uint32_t i = 0; i < svm_len_; i++)
+      {
+        data[i] = spectrum_[order[i]];
+      }
+    }
+    else
+    {
+      std::generate(data, data + svm_len_, rand_ampl);
+    }
+  }
+
   // Parameters
   std::vector<bpt_key_t> sensor_ids_; // Could be a reference?
   uint32_t sample_count_; 
@@ -237,6 +449,10 @@ private:
   static std::mt19937 engine_; // Mersenne twister MT19937
   static std::default_random_engine shuffler_;
   bounded_distribution<data_item_t> distribution_;
+  const std::vector<uint16_t>* bin_order_;
+  std::vector<data_item_t> spectrum_;
+  datagram_t header_; // For place_next_input()
+  std::vector<data_item_t> payload_; // For rejected headers
   // Simulated dataset & cursors
   std::vector<uint32_t> sensor_indices_;
   uint32_t current_seq_id_;
@@ -247,743 +463,2898 @@ bool input_simulator::engine_initialised_ = false;
 std::default_random_engine input_simulator::shuffler_;
 std::mt19937 input_simulator::engine_; // Mersenne twister MT19937
 
-////////////////////////////////////////////////////////////////
-// B+Tree for storing per-sensor data
-////////////////////////////////////////////////////////////////
-
-// Key is a numeric GUID
-// Data is a row number in  the storage area (weights vector)
-typedef uint32_t bpt_data_t;
-
-template <typename Key, typename Value, int mult_factor, int div_factor>
-struct btree_modified_traits {
-  typedef tlx::btree_default_traits<Key, std::pair<Key, Value> > bpt_base_traits;
-  static const bool self_verify = bpt_base_traits::self_verify;
-  static const bool debug = bpt_base_traits::debug;
-  static const int leaf_slots = (int)((bpt_base_traits::leaf_slots * mult_factor) / div_factor);
-  static const int inner_slots = (int)((bpt_base_traits::inner_slots * mult_factor) / div_factor);
-  static const size_t binsearch_threshold = bpt_base_traits::binsearch_threshold;
-};
-
-#ifndef NODE_COUNT_MULT_FACTOR
-#define NODE_COUNT_MULT_FACTOR 1
-#endif
-
-#ifndef NODE_COUNT_DIV_FACTOR
-#define NODE_COUNT_DIV_FACTOR 1
-#endif
-
-typedef btree_modified_traits<bpt_key_t, bpt_data_t, 
-    // 1, 1> bpt_traits;
-    NODE_COUNT_MULT_FACTOR, NODE_COUNT_DIV_FACTOR> bpt_traits;
-
-// typedef tlx::btree_default_traits<bpt_key_t, std::pair<bpt_key_t, bpt_data_t> > bpt_traits;
-
-typedef tlx::btree_map<bpt_key_t, bpt_data_t, bpt_key_less, bpt_traits> bpt_map_t;
-// typedef tlx::btree_map<bpt_key_t, bpt_data_t, bpt_key_less> bpt_map_t;
-typedef bpt_map_t::btree_impl bpt_tree_t;
-
-////////////////////////////////////////////////////////////////
-// Run-time settings and command line parser
-////////////////////////////////////////////////////////////////
-
-struct run_time_settings_t
+// Command frames (commands.h) carry this sensor ID
+static bool is_command_frame(const datagram_t* pdata)
 {
-  // Run-time
-  uint16_t verbosity;
-  // Data size
-  uint32_t sensor_count;
-  uint32_t sample_count;
-  uint32_t datagram_size;
-  uint32_t repeats;
-  uint16_t task_count;
-  // Canned data
-  std::string weights_file;
-  // Simulator
-  bool simulate_weights;
-  rnd_bounds weights_bounds;
-
-  // Transmitted/received data
-  bool simulate_amplitudes;
-
-  // Canned data
-  std::string data_source;
-  // Simulator
-  rnd_bounds amplitude_bounds;
-
-  // Report
-  bool skip_header;
-  std::string report_file;
-  std::string perf_file;
-  // Cached
-  uint32_t sv_len;
-  uint32_t x_len;
-  uint32_t w_len;
+  const uint8_t* id = reinterpret_cast<const uint8_t*>(&pdata->sensor_id);
+  return std::all_of(id, id + sizeof(pdata->sensor_id), [](uint8_t b) { return b == 0xff; });
+}
 
-  // Execution
-  int exec_pattern;
-  int exec_model; // Current model
-  uint32_t delay_ms; // Initial delay in ms
-  uint32_t between_ms; // Wait between operations in ms
+/**
+ * @brief Datagrams from a UDP port, drained recv_batch at a time by a
+ * datagram_socket (recvmmsg or io_uring)
+ *
+ * A period (one repeat) ends after sensor_count * sample_count data
+ * datagrams, on CMD_ID_RESET_SEQUENCES, or when the port has been quiet
+ * for UDP_PERIOD_TIMEOUT_MS after some data. CMD_ID_STOP_SERVER ends the
+ * run; CMD_ID_USE_* choose the execution pattern for the next period.
+ */
+#define UDP_PERIOD_TIMEOUT_MS 1000
+#define UDP_RCVBUF_BYTES (16 * 1024 * 1024)
 
-  void validate()
+class udp_receiver : public input_receiver {
+public:
+  udp_receiver(std::unique_ptr<datagram_socket> socket, uint32_t datagram_size, uint64_t period_datagrams)
+    : socket_(std::move(socket)), datagram_size_(datagram_size), period_datagrams_(period_datagrams)
   {
-    if (sensor_count == 0)
+  }
+  virtual ~udp_receiver() {}
+  // Datagrams still queued from the last batch are kept for the next period
+  virtual void reset()
+  {
+    received_ = 0;
+  }
+  // Thread CPU time is counted from the first call of a period to the
+  // last, which returns false: receiving and ingesting, not inference
+  virtual bool get_next_input(std::vector<data_item_t>& buffer)
+  {
+    const datagram_t* pdata = next_datagram();
+    if (pdata)
     {
-      throw std::domain_error("sensor_count must be positive");
+      buffer.resize(datagram_size_ / sizeof(data_item_t));
+      memcpy(static_cast<void*>(buffer.data()), pdata, datagram_size_);
     }
-    if (sample_count == 0)
+    return pdata != nullptr;
+  }
+  // The header is validated where the socket put it, and the payload
+  // copied from there into its row
+  virtual bool place_next_input(input_placer& placer, bool& placed)
+  {
+    const datagram_t* pdata = next_datagram();
+    if (!pdata)
     {
-      throw std::domain_error("sample_count must be positive");
+      return false;
     }
-
-    if (!simulate_weights && weights_file.empty())
+    data_item_t* row = placer.place(*pdata);
+    placed = (row != nullptr);
+    if (row)
     {
-      throw std::domain_error("if simulate_weights is false, weights_file must be provided");
+      memcpy(static_cast<void*>(row), pdata->data, placer.row_length() * sizeof(data_item_t));
     }
-    if (simulate_weights && !weights_bounds.is_valid())
+    return true;
+  }
+  virtual bool stop_requested() const { return stop_; }
+  virtual bool pattern_requested(int& pattern)
+  {
+    if (pattern_ < 0)
     {
-      throw std::domain_error("weights.min may not be greater than weights.max; weights.granularity must be non-zero.");
+      return false;
+    }
+    pattern = pattern_;
+    pattern_ = -1;
+    return true;
+  }
+  virtual bool lossy() const { return true; }
+
+  uint16_t port() const { return socket_->port(); }
+  const char* backend_name() const { return socket_->backend_name(); }
+  uint64_t datagram_count() const { return datagrams_; }
+  uint64_t malformed_count() const { return malformed_; }
+  // Data datagrams per second, first to last
+  double datagrams_per_second() const
+  {
+    double seconds = std::chrono::duration<double>(last_at_ - first_at_).count();
+    return (seconds > 0.0) ? (double)datagrams_ / seconds : 0.0;
+  }
+  double syscalls_per_datagram() const
+  {
+    return socket_->datagram_count() ? (double)socket_->syscall_count() / (double)socket_->datagram_count() : 0.0;
+  }
+  // Receive and ingest CPU time per 100k data datagrams
+  double cpu_us_per_100k() const
+  {
+    return datagrams_ ? ((double)cpu_ns_ / 1000.0) * (100000.0 / (double)datagrams_) : 0.0;
+  }
+private:
+  static uint64_t thread_cpu_ns()
+  {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+  }
+
+  // The next data datagram of the period, in the socket's slot, or
+  // nullptr when the period is over
+  const datagram_t* next_datagram()
+  {
+    if (!in_period_)
+    {
+      in_period_ = true;
+      cpu_started_at_ = thread_cpu_ns();
     }
-    if (task_count == 0 || task_count >= 17)
+    const datagram_t* pdata = receive_datagram();
+    if (!pdata)
     {
-      throw std::domain_error("task_count must be a positive integer less than 17");
+      in_period_ = false;
+      cpu_ns_ += thread_cpu_ns() - cpu_started_at_;
     }
-    if (datagram_size < sizeof(datagram_t))
+    return pdata;
+  }
+
+  const datagram_t* receive_datagram()
+  {
+    while (!stop_ && received_ < period_datagrams_)
     {
-      throw std::domain_error(std::string("datagram_size is less than header size (") + std::to_string(sizeof(datagram_t)) + ")");
+      if (next_ == count_)
+      {
+        next_ = 0;
+        count_ = socket_->receive();
+        if (count_ == 0)
+        {
+          // Quiet: the period is over if it has started
+          if (received_ > 0)
+          {
+            return nullptr;
+          }
+          continue;
+        }
+      }
+      size_t i = next_++;
+      const datagram_t* pdata = reinterpret_cast<const datagram_t*>(socket_->data(i));
+      size_t length = socket_->length(i);
+      if (length < offsetof(datagram_t, data) || socket_->truncated(i))
+      {
+        malformed_++;
+        continue;
+      }
+      if (is_command_frame(pdata))
+      {
+        if (command(pdata->seq_id) && received_ > 0)
+        {
+          return nullptr;
+        }
+        continue;
+      }
+      if (length != datagram_size_)
+      {
+        malformed_++;
+        continue;
+      }
+      auto now = std::chrono::steady_clock::now();
+      if (datagrams_ == 0)
+      {
+        first_at_ = now;
+      }
+      last_at_ = now;
+      datagrams_++;
+      received_++;
+      return pdata;
     }
-    sv_len = svm_len_from_datagram_bytes(datagram_size);
-    if (sv_len < MIN_SV_LEN)
+    return nullptr;
+  }
+
+  // Acts on a command; true if it ends the period
+  bool command(uint32_t cmd)
+  {
+    switch (cmd)
     {
-      throw std::domain_error("support vector length must be at least " XSTR(MIN_SV_LEN));
+    case CMD_ID_RESET_SEQUENCES:
+      return true;
+    case CMD_ID_STOP_SERVER:
+      stop_ = true;
+      return true;
+    case CMD_ID_USE_SEQ:
+      pattern_ = EXEC_PATTERN_SEQ;
+      break;
+    case CMD_ID_USE_CORO:
+      pattern_ = EXEC_PATTERN_CORO;
+      break;
+    case CMD_ID_USE_BOTH:
+      pattern_ = EXEC_PATTERN_BOTH;
+      break;
+    default:
+      malformed_++;
+      break;
     }
-    x_len = datagram_size / sizeof(data_item_t);
-    w_len = sv_len + 1;
+    return false;
+  }
+
+  std::unique_ptr<datagram_socket> socket_;
+  uint32_t datagram_size_;
+  uint64_t period_datagrams_;
+  uint64_t received_ = 0; // This period
+  size_t count_ = 0; // In the last batch
+  size_t next_ = 0;
+  bool stop_ = false;
+  int pattern_ = -1;
+  uint64_t datagrams_ = 0;
+  uint64_t malformed_ = 0;
+  std::chrono::steady_clock::time_point first_at_, last_at_;
+  bool in_period_ = false;
+  uint64_t cpu_started_at_ = 0; // ns
+  uint64_t cpu_ns_ = 0;
+};
 
-    if (!simulate_amplitudes && data_source.empty())
+/**
+ * @brief Opens the receive socket for recv_backend; RECV_BACKEND_AUTO
+ * falls back to recvmmsg when io_uring cannot be set up
+ */
+std::unique_ptr<datagram_socket> open_datagram_socket(int recv_backend, uint16_t port,
+  uint32_t datagram_size, size_t recv_batch, uint16_t verbosity)
+{
+  if (recv_backend != RECV_BACKEND_RECVMMSG)
+  {
+    try
     {
-      throw std::domain_error("if simulate is false, data_source must be provided");
+      return std::make_unique<uring_batch_socket>(port, datagram_size, recv_batch,
+        UDP_PERIOD_TIMEOUT_MS, UDP_RCVBUF_BYTES);
     }
-    if (simulate_amplitudes && !amplitude_bounds.is_valid())
+    catch (const std::exception &ex)
     {
-      throw std::domain_error("amplitudes.min may not be greater than amplitudes.max; amplitudes.granularity must be non-zero.");
+      if (recv_backend == RECV_BACKEND_IO_URING)
+      {
+        throw;
+      }
+      if (verbosity > 0)
+      {
+        std::cerr << "io_uring unavailable (" << ex.what() << "), using recvmmsg\r\n";
+      }
     }
   }
+  return std::make_unique<udp_batch_socket>(port, datagram_size, recv_batch,
+    UDP_PERIOD_TIMEOUT_MS, UDP_RCVBUF_BYTES);
+}
 
-  void dump(std::ostream &os)
-  {
-    os << "verbosity"
-       << "\t" << verbosity << std::endl;
-    os << "sensor_count"
-       << "\t" << sensor_count << std::endl;
-    os << "sample_count"
-       << "\t" << sample_count << std::endl;
-    os << "datagram_size"
-       << "\t" << datagram_size << std::endl;
-    os << "task_count"
-       << "\t" << task_count << std::endl;
-    os << "simulate_weights"
-       << "\t" << simulate_weights << std::endl;
-    os << "weights_file"
-       << "\t" << weights_file << std::endl;
-    os << "weights_bounds"
-       << "\t" << weights_bounds << std::endl;
-
-    os << "data_source"
-       << "\t" << data_source << std::endl;
-    os << "amplitude_bounds"
-       << "\t" << amplitude_bounds << std::endl;
-
-    os << "skip_header"
-       << "\t" << skip_header << std::endl;
-    os << "report_file"
-       << "\t" << report_file << std::endl;
-    os << "perf_file"
-       << "\t" << perf_file << std::endl;
-
-    os << "sv_len"
-       << "\t" << sv_len << std::endl;
-    os << "x_len"
-       << "\t" << x_len << std::endl;
-    os << "w_len"
-       << "\t" << w_len << std::endl;
+/**
+ * @brief Replays a capture file (capture.h): each period (repeat) takes
+ * the next recorded period, wrapping round. Records are datagrams in
+ * place in the mapping, so they are placed into their rows unparsed.
+ */
+class capture_receiver : public input_receiver {
+public:
+  explicit capture_receiver(const std::string& path) : file_(path) {}
+  virtual ~capture_receiver() {}
+  virtual void reset()
+  {
+    const capture_header_t& h = file_.header();
+    next_ = end_ = 0;
+    if (h.period_count > 0)
+    {
+      uint32_t p = period_++ % h.period_count;
+      next_ = file_.period_begin(p);
+      end_ = file_.period_end(p);
+    }
+  }
+  virtual bool get_next_input(std::vector<data_item_t>& buffer)
+  {
+    if (next_ == end_)
+    {
+      return false;
+    }
+    uint32_t datagram_size = file_.header().datagram_size;
+    buffer.resize(datagram_size / sizeof(data_item_t));
+    memcpy(static_cast<void*>(buffer.data()), file_.record(next_++), datagram_size);
+    return true;
+  }
+  virtual bool place_next_input(input_placer& placer, bool& placed)
+  {
+    if (next_ == end_)
+    {
+      return false;
+    }
+    const datagram_t* pdata = reinterpret_cast<const datagram_t*>(file_.record(next_++));
+    data_item_t* row = placer.place(*pdata);
+    placed = (row != nullptr);
+    if (row)
+    {
+      memcpy(static_cast<void*>(row), pdata->data, placer.row_length() * sizeof(data_item_t));
+    }
+    return true;
+  }
+  virtual bool stop_requested() const { return false; }
 
-    os << "exec_pattern"
-       << "\t" << exec_pattern << std::endl;
-    os << "exec_model"
-       << "\t" << exec_model << std::endl;
-    os << "delay_ms"
-       << "\t" << delay_ms << std::endl;
-    os << "between_ms"
-       << "\t" << between_ms << std::endl;
+  const capture_file& file() const { return file_; }
+private:
+  capture_file file_;
+  uint32_t period_ = 0; // Next to replay
+  uint64_t next_ = 0;
+  uint64_t end_ = 0;
+};
 
-    os << "repeats"
-       << "\t" << repeats << std::endl;
+/**
+ * @brief Passes another receiver's datagrams through, recording them to
+ * a capture file, a period at a time
+ */
+class recording_receiver : public input_receiver {
+public:
+  recording_receiver(std::unique_ptr<input_receiver> source, std::unique_ptr<capture_writer> writer)
+    : source_(std::move(source)), writer_(std::move(writer))
+  {
+  }
+  virtual ~recording_receiver() {}
+  virtual void reset()
+  {
+    writer_->end_period();
+    source_->reset();
+  }
+  // Staged, so that the datagram can be recorded (see input_receiver::place_next_input)
+  virtual bool get_next_input(std::vector<data_item_t>& buffer)
+  {
+    if (!source_->get_next_input(buffer))
+    {
+      return false;
+    }
+    writer_->write(buffer.data());
+    return true;
   }
+  virtual bool stop_requested() const { return source_->stop_requested(); }
+  virtual bool pattern_requested(int& pattern) { return source_->pattern_requested(pattern); }
+  virtual bool lossy() const { return source_->lossy(); }
+
+  uint64_t record_count() const { return writer_->record_count(); }
+private:
+  std::unique_ptr<input_receiver> source_;
+  std::unique_ptr<capture_writer> writer_;
 };
 
 /**
- * @brief Parses the command line arguments into a run-time
- * settings structure
- *
- * @param argc The command line argument count
- * @param argv The command line arguments
- * @param rt run-time settings to be populated by the parser
- * @return true if parsing succeeds
- * @return false on parsing error
+ * @brief Hands on another receiver's datagrams no earlier than their
+ * intended arrival times (load_gen.h), and keeps those times for the
+ * latency of the period's results. The schedule runs on across periods:
+ * time spent on inference delays the next period's datagrams rather
+ * than pausing the schedule.
  */
-bool parse_cmd_line(int argc, char **argv, run_time_settings_t &rt)
-{
-  try
+class paced_receiver : public input_receiver {
+public:
+  paced_receiver(std::unique_ptr<input_receiver> source, double rate, int arrivals)
+    : source_(std::move(source)), schedule_(rate, arrivals)
   {
-    // Used: abcdefgijkmnqrstuvwxy
-    // Unused: p
-    // Available: loz
-    TCLAP::CmdLine cmd("Multi-sensor SVM Inference self-contained test utility", ' ', "0.4");
+  }
+  virtual ~paced_receiver() {}
+  virtual void reset()
+  {
+    intended_.clear();
+    source_->reset();
+  }
+  virtual bool get_next_input(std::vector<data_item_t>& buffer)
+  {
+    if (!source_->get_next_input(buffer))
+    {
+      return false;
+    }
+    arrive();
+    return true;
+  }
+  // The datagram arrives once its header is ready to be placed
+  virtual bool place_next_input(input_placer& placer, bool& placed)
+  {
+    pacing_placer pacing(*this, placer);
+    return source_->place_next_input(pacing, placed);
+  }
+  virtual bool stop_requested() const { return source_->stop_requested(); }
+  virtual bool pattern_requested(int& pattern) { return source_->pattern_requested(pattern); }
+  virtual bool lossy() const { return source_->lossy(); }
 
-    TCLAP::ValueArg<uint16_t> verbosity_arg("v", "verbosity", "Verbosity level (0 is quiet)", false, 0, "non-negative integer");
-    TCLAP::ValueArg<uint16_t> task_count_arg("t", "task_count", "Task count (1-16)", false, 1, "non-negative integer below 17");
-    TCLAP::ValueArg<uint32_t> sensor_count_arg("s", "sensors", "Maximum number of sensors supported", true, 0, "positive integer");
-    TCLAP::ValueArg<uint32_t> sample_count_arg("c", "samples", "Number of samples per sensor", true, 0, "positive integer");
-    TCLAP::ValueArg<uint32_t> datagram_size_arg("d", "datagram", "Datagram size in bytes", true, 0, "positive integer");
+  // Records the latency of each datagram of the period, from its
+  // intended arrival to completed_at (deadline_clock_ns())
+  void complete_period(uint64_t completed_at, latency_recorder& latencies)
+  {
+    for (uint64_t due : intended_)
+    {
+      latencies.add(completed_at > due ? completed_at - due : 0);
+    }
+    completed_ += intended_.size();
+    completed_at_ = completed_at;
+    intended_.clear();
+  }
+  // Datagrams completed per second, from the start of the schedule
+  double achieved_rate() const
+  {
+    return (completed_at_ > started_at_) ? (double)completed_ * 1e9 / (double)(completed_at_ - started_at_) : 0.0;
+  }
+  // Datagrams handed on after their intended time
+  uint64_t late_count() const { return late_; }
+private:
+  class pacing_placer : public input_placer {
+  public:
+    pacing_placer(paced_receiver& owner, input_placer& placer) : owner_(owner), placer_(placer) {}
+    virtual data_item_t* place(const datagram_t& header)
+    {
+      owner_.arrive();
+      return placer_.place(header);
+    }
+    virtual size_t row_length() const { return placer_.row_length(); }
+  private:
+    paced_receiver& owner_;
+    input_placer& placer_;
+  };
+
+  // Waits for the next intended arrival, unless it has passed
+  void arrive()
+  {
+    uint64_t now = deadline_clock_ns();
+    if (started_at_ == 0)
+    {
+      started_at_ = now;
+    }
+    uint64_t due = started_at_ + schedule_.next();
+    if (now >= due)
+    {
+      late_ += (now > due) ? 1 : 0;
+    }
+    while (now < due)
+    {
+      // Sleep while far off, then spin: sleeps overshoot
+      if (due - now > PACE_SPIN_NS)
+      {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(due - now - PACE_SPIN_NS));
+      }
+      now = deadline_clock_ns();
+    }
+    intended_.push_back(due);
+  }
 
-    // TCLAP::ValueArg<uint32_t> port_num_arg("p", "port", "Port number of sensors supported", false, 8080, "positive integer");
+  static const uint64_t PACE_SPIN_NS = 100000;
 
-    TCLAP::SwitchArg simulate_weights_arg("i", "sim_weights", "Simulate weights", false);
-    TCLAP::ValueArg<std::string> weights_file_arg("w", "weights_file", "Path to weights file", false, "", "valid file path (relative or absolute)");
-    TCLAP::ValueArg<uint32_t> weights_granularity_arg("g", "weights_div", "Divider for simulated weights", false, 1024, "positive integer");
-    TCLAP::ValueArg<float> weights_min_arg("m", "weights_min", "Minimum simulated weight", false, -1.0, "real number");
-    TCLAP::ValueArg<float> weights_max_arg("n", "weights_max", "Maximum simulated weight", false, 1.0, "real number");
+  std::unique_ptr<input_receiver> source_;
+  arrival_schedule schedule_;
+  uint64_t started_at_ = 0;
+  std::vector<uint64_t> intended_; // This period
+  uint64_t completed_ = 0;
+  uint64_t completed_at_ = 0;
+  uint64_t late_ = 0;
+};
 
-    TCLAP::ValueArg<uint32_t> delay_arg("b", "delay", "Initial delay (ms)", false, 0, "non-negative integer");
-    TCLAP::ValueArg<uint32_t> between_arg("e", "between", "Wait between operations (ms)", false, 100, "non-negative integer");
-    TCLAP::ValueArg<uint32_t> repeats_arg("a", "repeats", "Number of times data set is repeated", false, 1, "non-negative integer");
-    TCLAP::ValueArg<std::string> data_source_arg("u", "source", "Path to data source file", false, "", "valid file path (relative or absolute)");
-    TCLAP::ValueArg<uint32_t> amplitude_granularity_arg("j", "ampl_div", "Divider for simulated amplitudes", false, 1024, "positive integer");
-    TCLAP::ValueArg<float> amplitude_min_arg("q", "ampl_min", "Minimum simulated amplitude", false, -1.0, "real number");
-    TCLAP::ValueArg<float> amplitude_max_arg("x", "ampl_max", "Maximum simulated amplitude", false, 1.0, "real number");
+////////////////////////////////////////////////////////////////
+// B+Tree for storing per-sensor data
+////////////////////////////////////////////////////////////////
 
-    TCLAP::SwitchArg skip_header_arg("k", "skip_header", "Skip report header line", false);
-    TCLAP::ValueArg<std::string> report_file_arg("y", "report_file", "Path to report file", false, "", "valid file path (relative or absolute), - for cout");
-    TCLAP::ValueArg<std::string> perf_file_arg("f", "perf_file", "Path to report file for perf data", false, "", "valid file path (relative or absolute), - for cout");
+// Key is a numeric GUID
+// Data is a row number in  the storage area (weights vector)
+typedef uint32_t bpt_data_t;
 
-    cmd.add(verbosity_arg);
-    cmd.add(task_count_arg);
-    cmd.add(sensor_count_arg);
-    cmd.add(sample_count_arg);
-    cmd.add(datagram_size_arg);
+template <typename Key, typename Value, int mult_factor, int div_factor>
+struct btree_modified_traits {
+  typedef tlx::btree_default_traits<Key, std::pair<Key, Value> > bpt_base_traits;
+  static const bool self_verify = bpt_base_traits::self_verify;
+  static const bool debug = bpt_base_traits::debug;
+  static const int leaf_slots = (int)((bpt_base_traits::leaf_slots * mult_factor) / div_factor);
+  static const int inner_slots = (int)((bpt_base_traits::inner_slots * mult_factor) / div_factor);
+  static const size_t binsearch_threshold = bpt_base_traits::binsearch_threshold;
+};
 
-    // cmd.add(port_num_arg);
+#ifndef NODE_COUNT_MULT_FACTOR
+#define NODE_COUNT_MULT_FACTOR 1
+#endif
 
-    cmd.add(simulate_weights_arg);
-    cmd.add(weights_file_arg);
-    cmd.add(weights_granularity_arg);
-    cmd.add(weights_min_arg);
-    cmd.add(weights_max_arg);
+#ifndef NODE_COUNT_DIV_FACTOR
+#define NODE_COUNT_DIV_FACTOR 1
+#endif
 
-    cmd.add(delay_arg);
-    cmd.add(between_arg);
-    cmd.add(repeats_arg);
-    cmd.add(data_source_arg);
-    cmd.add(amplitude_granularity_arg);
-    cmd.add(amplitude_min_arg);
-    cmd.add(amplitude_max_arg);
+typedef btree_modified_traits<bpt_key_t, bpt_data_t, 
+    // 1, 1> bpt_traits;
+    NODE_COUNT_MULT_FACTOR, NODE_COUNT_DIV_FACTOR> bpt_traits;
 
-    cmd.add(skip_header_arg);
-    cmd.add(report_file_arg);
-    cmd.add(perf_file_arg);
+// typedef tlx::btree_default_traits<bpt_key_t, std::pair<bpt_key_t, bpt_data_t> > bpt_traits;
+
+typedef tlx::btree_map<bpt_key_t, bpt_data_t, bpt_key_less, bpt_traits> bpt_map_t;
+// typedef tlx::btree_map<bpt_key_t, bpt_data_t, bpt_key_less> bpt_map_t;
+typedef bpt_map_t::btree_impl bpt_tree_t;
+
+// The steps of bpt_tree_t::find(), for lookups that suspend between 
+// nodes (see ingest_datagram_coro)
+class btree_accessor
+{
+public:
+  typedef bpt_tree_t::node node_t;
+  typedef bpt_tree_t::InnerNode inner_node_t;
+  typedef bpt_tree_t::LeafNode leaf_node_t;
+
+  static const node_t* root(const bpt_map_t& map)
+  {
+    return map.tree_.root_;
+  }
+  // Size of the nodes at a level (0 for leaves)
+  static size_t node_bytes(unsigned short level)
+  {
+    return level ? sizeof(inner_node_t) : sizeof(leaf_node_t);
+  }
+  // The child of an inner node that covers key
+  static const node_t* child(const bpt_map_t& map, const node_t* n, const bpt_key_t& key)
+  {
+    const inner_node_t* inner = static_cast<const inner_node_t*>(n);
+    return inner->childid[map.tree_.find_lower(inner, key)];
+  }
+  // Looks key up in a leaf
+  static bool leaf_find(const bpt_map_t& map, const node_t* n, const bpt_key_t& key, bpt_data_t& data)
+  {
+    const leaf_node_t* leaf = static_cast<const leaf_node_t*>(n);
+    unsigned short slot = map.tree_.find_lower(leaf, key);
+    if (slot < leaf->slotuse && map.tree_.key_equal(key, leaf->key(slot)))
+    {
+      data = leaf->slotdata[slot].second;
+      return true;
+    }
+    return false;
+  }
+};
+
+////////////////////////////////////////////////////////////////
+// Run-time settings and command line parser
+////////////////////////////////////////////////////////////////
+
+struct run_time_settings_t
+{
+  // Run-time
+  uint16_t verbosity;
+  // Data size
+  uint32_t sensor_count;
+  uint32_t sample_count;
+  uint32_t datagram_size;
+  uint32_t repeats;
+  uint16_t task_count;
+  uint16_t thread_count; // Workers for EXEC_MODEL_THREADS
+  uint16_t block_size;
+  uint16_t class_count;
+  // Kernel
+  std::string isa_name;
+  svm_isa_t isa;
+  std::string accumulator_name;
+  int accumulator;
+  std::string kernel_name;
+  svm_kernel_type_t kernel_type;
+  uint32_t sv_count; // Support vectors per sensor (kernel SVMs)
+  float gamma;
+  float coef0;
+  uint16_t degree;
+  bool early_exit; // Stop scoring once the decision is certain
+  std::string weights_format_name;
+  int weights_format;
+  float weights_density; // Fraction of simulated weights that are non-zero
+  bool generic_length; // Do not use kernels specialised for sv_len
+  bool fixed_length; // A kernel specialised for sv_len is used
+  // Canned data
+  std::string weights_file;
+  // Simulator
+  bool simulate_weights;
+  rnd_bounds weights_bounds;
+
+  // Transmitted/received data
+  bool simulate_amplitudes;
+
+  // Canned data
+  std::string data_source; // Capture file to replay (capture.h)
+  std::string record_file; // Capture file to record the input to
+  // Network
+  uint16_t port; // UDP port to receive on; 0 for simulated input
+  uint16_t recv_batch; // Datagrams per receive call
+  // Load generation
+  double rate; // Datagrams per second, open loop; 0 for as fast as possible
+  std::string arrivals_name;
+  int arrivals;
+  std::string recv_backend_name;
+  int recv_backend;
+  // Simulator
+  rnd_bounds amplitude_bounds;
+
+  // Report
+  bool skip_header;
+  std::string report_file;
+  std::string perf_file;
+  // Cached
+  uint32_t sv_len;
+  uint32_t x_len;
+  uint32_t w_len;
+  uint32_t bank_rows;
+  uint32_t bank_len;
+  uint32_t q8_bank_len; // Int8 weights per sensor
+  uint32_t exit_chunk; // Bins between early exit checks
+  uint32_t exit_bounds_len; // Suffix bounds per sensor
+
+  // Execution
+  int exec_pattern;
+  int exec_model; // Current model
+  std::string compare_model_name;
+  int compare_model; // Model run between the two sequential runs
+  uint32_t delay_ms; // Initial delay in ms
+  uint32_t between_ms; // Wait between operations in ms
+  std::string runner_name;
+  int runner;
+  bool heap_frames; // Allocate coroutine frames from the heap, not a pool
+  bool autotune; // Choose task count and prefetch policy by measurement
+  bool autotune_cycles; // Measure calibration slices in CPU cycles
+  uint16_t ingest_batch; // Datagrams saved together; 1 saves each as it comes
+  uint16_t prefetch_distance; // Sensors and row blocks ahead, for EXEC_MODEL_PIPELINED
+  uint16_t suspend_lines; // Most lines infer_sensor_coro prefetches per suspension
+  bool suspend_lines_sized; // suspend_lines was given as 0, so follows the task count run
+  uint32_t deadline_us; // From the start of a run, for EXEC_MODEL_DEADLINE
+  uint32_t alarm_deadline_us; // As deadline_us, for sensors whose last result was positive
+  cache_topology_t topology; // Found at startup; sizes task_count, block_size and suspend_lines when 0
+
+  void validate()
+  {
+    if (sensor_count == 0)
+    {
+      throw std::domain_error("sensor_count must be positive");
+    }
+    if (sample_count == 0)
+    {
+      throw std::domain_error("sample_count must be positive");
+    }
+
+    if (!simulate_weights && weights_file.empty())
+    {
+      throw std::domain_error("if simulate_weights is false, weights_file must be provided");
+    }
+    if (simulate_weights && !weights_bounds.is_valid())
+    {
+      throw std::domain_error("weights.min may not be greater than weights.max; weights.granularity must be non-zero.");
+    }
+    if (task_count >= 17)
+    {
+      throw std::domain_error("task_count must be less than 17");
+    }
+    if (block_size > SVM_MAX_BLOCK)
+    {
+      throw std::domain_error("block_size must be no greater than " XSTR(SVM_MAX_BLOCK));
+    }
+    if (datagram_size < sizeof(datagram_t))
+    {
+      throw std::domain_error(std::string("datagram_size is less than header size (") + std::to_string(sizeof(datagram_t)) + ")");
+    }
+    sv_len = svm_len_from_datagram_bytes(datagram_size);
+    if (sv_len < MIN_SV_LEN)
+    {
+      throw std::domain_error("support vector length must be at least " XSTR(MIN_SV_LEN));
+    }
+    x_len = datagram_size / sizeof(data_item_t);
+    w_len = sv_len + 1;
+    if (class_count == 0 || class_count > SVM_MAX_CLASSES)
+    {
+      throw std::domain_error("class_count must be a positive integer no greater than " XSTR(SVM_MAX_CLASSES));
+    }
+
+    // A kernel model is a bank of sv_count rows: coefficient & support vector
+    kernel_type = svm_kernel_from_name(kernel_name);
+    if (kernel_type != SVM_KERNEL_LINEAR)
+    {
+      if (class_count != 1)
+      {
+        throw std::domain_error("kernel SVMs support one class only");
+      }
+      if (sv_count == 0)
+      {
+        throw std::domain_error("sv_count must be positive");
+      }
+      if (degree == 0)
+      {
+        throw std::domain_error("degree must be positive");
+      }
+    }
+    bank_rows = (kernel_type == SVM_KERNEL_LINEAR) ? class_count : sv_count;
+    bank_len = w_len * bank_rows;
+    size_cache_defaults();
+
+    accumulator = -1;
+    for (int i = 0; accumulator_names[i]; i++)
+    {
+      if (accumulator_name == accumulator_names[i])
+      {
+        accumulator = i;
+      }
+    }
+    if (accumulator < 0)
+    {
+      throw std::domain_error("accumulator must be one of narrow, wide32, wide64");
+    }
+    isa = svm_isa_from_name(isa_name);
+    if (!svm_isa_supported(isa))
+    {
+      throw std::domain_error(std::string("isa ") + svm_isa_name(isa) + " is not supported on this platform");
+    }
+    // The raw kernels always accumulate in 64 bits
+    if (accumulator != ACCUM_WIDE64 && isa != SVM_ISA_GENERIC)
+    {
+      if (isa_name != "auto")
+      {
+        throw std::domain_error("the " + accumulator_name + " accumulator requires isa generic");
+      }
+      isa = SVM_ISA_GENERIC;
+    }
+    if (accumulator != ACCUM_WIDE64 && kernel_type != SVM_KERNEL_LINEAR)
+    {
+      throw std::domain_error("kernel SVMs require the wide64 accumulator");
+    }
+
+    compare_model = -1;
+    for (int i = 0; exec_model_names[i]; i++)
+    {
+      if (compare_model_name == exec_model_names[i])
+      {
+        compare_model = i;
+      }
+    }
+    if (compare_model < 0)
+    {
+      throw std::domain_error("exec_model must be one of seq, coro, symmetric, threads, amac, pipelined, deadline");
+    }
+    if ((compare_model == EXEC_MODEL_AMAC || compare_model == EXEC_MODEL_PIPELINED) 
+      && kernel_type != SVM_KERNEL_LINEAR)
+    {
+      throw std::domain_error(std::string("exec_model ") + compare_model_name + " supports the linear kernel only");
+    }
+    if (prefetch_distance > 64)
+    {
+      throw std::domain_error("prefetch_distance must be at most 64");
+    }
+    if (deadline_us == 0 || alarm_deadline_us == 0)
+    {
+      throw std::domain_error("deadline_us and alarm_deadline_us must be positive");
+    }
+    if (thread_count == 0)
+    {
+      thread_count = (uint16_t)std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    if (thread_count > 64)
+    {
+      throw std::domain_error("threads must be at most 64");
+    }
+
+    runner = -1;
+    for (int i = 0; runner_names[i]; i++)
+    {
+      if (runner_name == runner_names[i])
+      {
+        runner = i;
+      }
+    }
+    if (runner < 0)
+    {
+      throw std::domain_error("runner must be one of poll, ring");
+    }
+    if (autotune && compare_model != EXEC_MODEL_CORO)
+    {
+      throw std::domain_error("autotune requires exec_model coro");
+    }
+    // Calibration slices run on the ring runner, so only its choice is measured
+    if (autotune && runner != RUNNER_RING)
+    {
+      throw std::domain_error("autotune requires runner ring");
+    }
+    if (autotune_cycles && !autotune)
+    {
+      throw std::domain_error("autotune_cycles requires autotune");
+    }
+    if (ingest_batch == 0 || ingest_batch > 64)
+    {
+      throw std::domain_error("ingest_batch must be between 1 and 64");
+    }
+
+    weights_format = -1;
+    for (int i = 0; weights_format_names[i]; i++)
+    {
+      if (weights_format_name == weights_format_names[i])
+      {
+        weights_format = i;
+      }
+    }
+    if (weights_format < 0)
+    {
+      throw std::domain_error("weights_format must be one of int16, int8, sparse, auto");
+    }
+    if (!(weights_density > 0.0f && weights_density <= 1.0f))
+    {
+      throw std::domain_error("weights_density must be greater than 0 and no greater than 1");
+    }
+    q8_bank_len = sv_len * bank_rows;
+    if (weights_format == WEIGHTS_INT8)
+    {
+      if (kernel_type != SVM_KERNEL_LINEAR)
+      {
+        throw std::domain_error("int8 weights require a linear kernel");
+      }
+      if (accumulator != ACCUM_WIDE64)
+      {
+        throw std::domain_error("int8 weights require the wide64 accumulator");
+      }
+      if (early_exit)
+      {
+        throw std::domain_error("int8 weights do not support early_exit");
+      }
+    }
+    if (weights_format == WEIGHTS_SPARSE || weights_format == WEIGHTS_AUTO)
+    {
+      if (kernel_type != SVM_KERNEL_LINEAR || class_count != 1)
+      {
+        throw std::domain_error("sparse weights require a linear kernel and one class");
+      }
+      if (accumulator != ACCUM_WIDE64 || early_exit)
+      {
+        throw std::domain_error("sparse weights require the wide64 accumulator and no early_exit");
+      }
+      if (sv_len > UINT16_MAX)
+      {
+        throw std::domain_error("sparse weights support at most 65535 bins");
+      }
+    }
+
+    // Whole rows are scored with a kernel specialised for sv_len, 
+    // where there is one
+    fixed_length = !generic_length && (svm_dot_kernel_for_length(isa, sv_len) != nullptr);
+
+    // Early exit needs a single linear model scored one row at a time,
+    // with the exact (wide64) totals of the raw kernels
+    exit_chunk = pf_line_size / sizeof(data_item_t);
+    exit_bounds_len = ((sv_len + exit_chunk - 1) / exit_chunk) + 1;
+    if (early_exit)
+    {
+      if (kernel_type != SVM_KERNEL_LINEAR || class_count != 1 || block_size != 1)
+      {
+        throw std::domain_error("early_exit requires a linear kernel, one class and block 1");
+      }
+      if (accumulator != ACCUM_WIDE64)
+      {
+        throw std::domain_error("early_exit requires the wide64 accumulator");
+      }
+      if (sv_len > UINT16_MAX)
+      {
+        throw std::domain_error("early_exit supports at most 65535 bins");
+      }
+    }
+
+    if (!simulate_amplitudes && data_source.empty() && port == 0)
+    {
+      throw std::domain_error("if simulate is false, data_source or port must be provided");
+    }
+    if (port != 0 && !data_source.empty())
+    {
+      throw std::domain_error("data_source and port may not both be given");
+    }
+    if ((port != 0 || !data_source.empty()) && early_exit)
+    {
+      // Only the simulator sends bins in the order of the weights
+      throw std::domain_error("early_exit requires simulated input");
+    }
+    if (!record_file.empty() && early_exit)
+    {
+      // The bins would be recorded in the order of the weights
+      throw std::domain_error("record_file may not be used with early_exit");
+    }
+    if (recv_batch == 0 || recv_batch > 1024)
+    {
+      throw std::domain_error("recv_batch must be a positive integer no greater than 1024");
+    }
+    recv_backend = -1;
+    for (int i = 0; recv_backend_names[i]; i++)
+    {
+      if (recv_backend_name == recv_backend_names[i])
+      {
+        recv_backend = i;
+      }
+    }
+    if (recv_backend < 0)
+    {
+      throw std::domain_error("recv_backend must be one of auto, io_uring, recvmmsg");
+    }
+    if (!(rate >= 0.0))
+    {
+      throw std::domain_error("rate must not be negative");
+    }
+    if (rate > 0.0 && port != 0)
+    {
+      throw std::domain_error("rate paces simulated or replayed input; UDP senders set their own rate");
+    }
+    arrivals = -1;
+    for (int i = 0; arrivals_names[i]; i++)
+    {
+      if (arrivals_name == arrivals_names[i])
+      {
+        arrivals = i;
+      }
+    }
+    if (arrivals < 0)
+    {
+      throw std::domain_error("arrivals must be one of fixed, poisson");
+    }
+    if (simulate_amplitudes && !amplitude_bounds.is_valid())
+    {
+      throw std::domain_error("amplitudes.min may not be greater than amplitudes.max; amplitudes.granularity must be non-zero.");
+    }
+  }
+
+  void dump(std::ostream &os)
+  {
+    os << "verbosity"
+       << "\t" << verbosity << std::endl;
+    os << "sensor_count"
+       << "\t" << sensor_count << std::endl;
+    os << "sample_count"
+       << "\t" << sample_count << std::endl;
+    os << "datagram_size"
+       << "\t" << datagram_size << std::endl;
+    os << "task_count"
+       << "\t" << task_count << std::endl;
+    os << "thread_count"
+       << "\t" << thread_count << std::endl;
+    os << "block_size"
+       << "\t" << block_size << std::endl;
+    os << "class_count"
+       << "\t" << class_count << std::endl;
+    os << "isa"
+       << "\t" << svm_isa_name(isa) << std::endl;
+    os << "accumulator"
+       << "\t" << accumulator_names[accumulator] << std::endl;
+    os << "kernel"
+       << "\t" << svm_kernel_name(kernel_type) << std::endl;
+    if (kernel_type != SVM_KERNEL_LINEAR)
+    {
+      os << "sv_count"
+         << "\t" << sv_count << std::endl;
+      os << "gamma"
+         << "\t" << gamma << std::endl;
+      os << "coef0"
+         << "\t" << coef0 << std::endl;
+      os << "degree"
+         << "\t" << degree << std::endl;
+    }
+    os << "weights_format"
+       << "\t" << weights_format_names[weights_format] << std::endl;
+    os << "weights_density"
+       << "\t" << weights_density << std::endl;
+    os << "fixed_length"
+       << "\t" << fixed_length << std::endl;
+    os << "early_exit"
+       << "\t" << early_exit << std::endl;
+    if (early_exit)
+    {
+      os << "exit_chunk"
+         << "\t" << exit_chunk << std::endl;
+      os << "exit_bounds_len"
+         << "\t" << exit_bounds_len << std::endl;
+    }
+    os << "simulate_weights"
+       << "\t" << simulate_weights << std::endl;
+    os << "weights_file"
+       << "\t" << weights_file << std::endl;
+    os << "weights_bounds"
+       << "\t" << weights_bounds << std::endl;
+
+    os << "data_source"
+       << "\t" << data_source << std::endl;
+    os << "record_file"
+       << "\t" << record_file << std::endl;
+    os << "port"
+       << "\t" << port << std::endl;
+    os << "recv_batch"
+       << "\t" << recv_batch << std::endl;
+    os << "recv_backend"
+       << "\t" << recv_backend_names[recv_backend] << std::endl;
+    os << "rate"
+       << "\t" << rate << std::endl;
+    os << "arrivals"
+       << "\t" << arrivals_names[arrivals] << std::endl;
+    os << "amplitude_bounds"
+       << "\t" << amplitude_bounds << std::endl;
+
+    os << "skip_header"
+       << "\t" << skip_header << std::endl;
+    os << "report_file"
+       << "\t" << report_file << std::endl;
+    os << "perf_file"
+       << "\t" << perf_file << std::endl;
+
+    os << "sv_len"
+       << "\t" << sv_len << std::endl;
+    os << "x_len"
+       << "\t" << x_len << std::endl;
+    os << "w_len"
+       << "\t" << w_len << std::endl;
+    os << "bank_rows"
+       << "\t" << bank_rows << std::endl;
+    os << "bank_len"
+       << "\t" << bank_len << std::endl;
+    os << "q8_bank_len"
+       << "\t" << q8_bank_len << std::endl;
+
+    os << "exec_pattern"
+       << "\t" << exec_pattern << std::endl;
+    os << "exec_model"
+       << "\t" << exec_model << std::endl;
+    os << "compare_model"
+       << "\t" << exec_model_names[compare_model] << std::endl;
+    os << "delay_ms"
+       << "\t" << delay_ms << std::endl;
+    os << "between_ms"
+       << "\t" << between_ms << std::endl;
+    os << "runner"
+       << "\t" << runner_names[runner] << std::endl;
+    os << "heap_frames"
+       << "\t" << heap_frames << std::endl;
+    os << "autotune"
+       << "\t" << autotune << std::endl;
+    os << "autotune_cycles"
+       << "\t" << autotune_cycles << std::endl;
+    os << "ingest_batch"
+       << "\t" << ingest_batch << std::endl;
+    os << "prefetch_distance"
+       << "\t" << prefetch_distance << std::endl;
+    os << "suspend_lines"
+       << "\t" << suspend_lines << std::endl;
+    os << "suspend_lines_sized"
+       << "\t" << suspend_lines_sized << std::endl;
+    os << "deadline_us"
+       << "\t" << deadline_us << std::endl;
+    os << "alarm_deadline_us"
+       << "\t" << alarm_deadline_us << std::endl;
+    topology.dump(os);
+
+    os << "repeats"
+       << "\t" << repeats << std::endl;
+  }
+
+  /**
+   * @brief Sizes task_count, block_size and suspend_lines, where given
+   * as 0, from the data cache
+   *
+   * The lines a task prefetches (its weights and a block of rows) must
+   * still be in L1 when the task resumes, so task_count is as many tasks
+   * as fit in half of L1. block_size is the most rows that fit, with
+   * one set of weights, in a quarter of L1. Early exit scores one row
+   * at a time. suspend_lines is each task's share of half of L1, but no
+   * more than a page; the auto-tuner resizes it for the task counts it
+   * runs (suspend_lines_for()).
+   */
+  void size_cache_defaults()
+  {
+    size_t row_bytes = x_len * sizeof(data_item_t);
+    size_t weight_bytes = bank_len * sizeof(data_item_t);
+    if (block_size == 0)
+    {
+      size_t budget = topology.l1d / 4;
+      size_t rows = (budget > weight_bytes) ? (budget - weight_bytes) / row_bytes : 1;
+      block_size = early_exit ? 1 : (uint16_t)std::clamp<size_t>(rows, 1, SVM_MAX_BLOCK);
+    }
+    if (task_count == 0)
+    {
+      size_t task_bytes = weight_bytes + block_size * row_bytes;
+      task_count = (uint16_t)std::clamp<size_t>((topology.l1d / 2) / task_bytes, 1, 16);
+    }
+    suspend_lines_sized = (suspend_lines == 0);
+    if (suspend_lines_sized)
+    {
+      suspend_lines = suspend_lines_for(task_count);
+    }
+  }
+  // Each of tasks' share of half of L1, in lines
+  uint16_t suspend_lines_for(size_t tasks) const
+  {
+    size_t share = (topology.l1d / 2) / (tasks * topology.line_size);
+    return (uint16_t)std::clamp<size_t>(share, 1, SUSPEND_MAX_BYTES / topology.line_size);
+  }
+};
+
+/**
+ * @brief Parses the command line arguments into a run-time
+ * settings structure
+ *
+ * @param argc The command line argument count
+ * @param argv The command line arguments
+ * @param rt run-time settings to be populated by the parser
+ * @return true if parsing succeeds
+ * @return false on parsing error
+ */
+bool parse_cmd_line(int argc, char **argv, run_time_settings_t &rt)
+{
+  try
+  {
+    // Used: abcdefgijkmnpqrstuvwxy
+    // Available: loz
+    // Long only: isa, accumulator, block, classes, kernel, sv_count, gamma, coef0, degree,
+    //   early_exit, weights_format, weights_density, generic_length, runner,
+    //   heap_frames, exec_model, threads, autotune, autotune_cycles, ingest_batch,
+    //   prefetch_distance, suspend_lines, deadline_us, alarm_deadline_us, recv_batch,
+    //   recv_backend, record, rate, arrivals
+    TCLAP::CmdLine cmd("Multi-sensor SVM Inference self-contained test utility", ' ', "0.4");
+
+    TCLAP::ValueArg<uint16_t> verbosity_arg("v", "verbosity", "Verbosity level (0 is quiet)", false, 0, "non-negative integer");
+    TCLAP::ValueArg<uint16_t> task_count_arg("t", "task_count", "Task count (1-16; 0 sizes it from the L1 data cache)", false, 0, "non-negative integer below 17");
+    TCLAP::ValueArg<uint16_t> class_count_arg("", "classes", "Number of one-vs-rest classes per sensor (1-" XSTR(SVM_MAX_CLASSES) ")", false, 1, "positive integer");
+    TCLAP::ValueArg<std::string> kernel_arg("", "kernel", "SVM kernel (linear, rbf, poly)", false, "linear", "kernel name");
+    TCLAP::ValueArg<uint32_t> sv_count_arg("", "sv_count", "Support vectors per sensor for kernel SVMs", false, 16, "positive integer");
+    TCLAP::ValueArg<float> gamma_arg("", "gamma", "Kernel gamma", false, 0.5, "real number");
+    TCLAP::ValueArg<float> coef0_arg("", "coef0", "Polynomial kernel coef0", false, 1.0, "real number");
+    TCLAP::ValueArg<uint16_t> degree_arg("", "degree", "Polynomial kernel degree", false, 2, "positive integer");
+    TCLAP::ValueArg<uint16_t> block_size_arg("", "block", "Sample rows scored per pass over the weights (1-" XSTR(SVM_MAX_BLOCK) "; 0 sizes it from the L1 data cache)", false, 1, "non-negative integer");
+    TCLAP::ValueArg<uint32_t> sensor_count_arg("s", "sensors", "Maximum number of sensors supported", true, 0, "positive integer");
+    TCLAP::ValueArg<uint32_t> sample_count_arg("c", "samples", "Number of samples per sensor", true, 0, "positive integer");
+    TCLAP::ValueArg<uint32_t> datagram_size_arg("d", "datagram", "Datagram size in bytes", true, 0, "positive integer");
+    TCLAP::ValueArg<std::string> isa_arg("", "isa", "SVM kernel ISA (auto, generic, scalar, sse4, avx2, neon)", false, "auto", "kernel name");
+    TCLAP::ValueArg<std::string> accumulator_arg("", "accumulator", "SVM accumulator (narrow, wide32, wide64)", false, "wide64", "accumulator name");
+    TCLAP::ValueArg<std::string> weights_format_arg("", "weights_format", "Weight storage (int16, int8, sparse, auto)", false, "int16", "format name");
+    TCLAP::ValueArg<float> weights_density_arg("", "weights_density", "Fraction of simulated weights that are non-zero, in bands", false, 1.0, "real number");
+    TCLAP::ValueArg<std::string> runner_arg("", "runner", "Coroutine runner (poll, ring)", false, "ring", "runner name");
+    TCLAP::ValueArg<std::string> exec_model_arg("", "exec_model", "Model compared against sequential (seq, coro, symmetric, threads, amac, pipelined, deadline)", false, "coro", "model name");
+    TCLAP::ValueArg<uint32_t> deadline_us_arg("", "deadline_us", "Deadline of each sensor from the start of a run, for the deadline model (us)", false, 10000, "positive integer");
+    TCLAP::ValueArg<uint32_t> alarm_deadline_us_arg("", "alarm_deadline_us", "As deadline_us, for sensors whose last result was positive (us)", false, 1000, "positive integer");
+    TCLAP::ValueArg<uint16_t> thread_count_arg("", "threads", "Worker threads for the threads model (0 for one per CPU)", false, 0, "non-negative integer");
+    TCLAP::SwitchArg autotune_arg("", "autotune", "Choose the coroutine task count and prefetch policy by calibration runs", false);
+    TCLAP::SwitchArg autotune_cycles_arg("", "autotune_cycles", "Compare calibration runs by CPU cycles (perf counters) rather than time", false);
+    TCLAP::ValueArg<uint16_t> ingest_batch_arg("", "ingest_batch", "Datagrams saved together, with interleaved lookups (1-64; 1 saves each on arrival)", false, 1, "positive integer");
+    TCLAP::ValueArg<uint16_t> suspend_lines_arg("", "suspend_lines", "Most lines a coroutine prefetches per suspension (0 sizes it from the L1 data cache)", false, 0, "non-negative integer");
+    TCLAP::ValueArg<uint16_t> prefetch_distance_arg("", "prefetch_distance", "Sensors and row blocks prefetched ahead by the pipelined model (0-64)", false, 2, "non-negative integer");
+    TCLAP::SwitchArg heap_frames_arg("", "heap_frames", "Allocate coroutine frames from the heap rather than a pool", false);
+    TCLAP::SwitchArg generic_length_arg("", "generic_length", "Do not use kernels specialised for the support vector length", false);
+    TCLAP::SwitchArg early_exit_arg("", "early_exit", "Order weights by magnitude and stop scoring once the decision is certain", false);
+
+    TCLAP::ValueArg<uint16_t> port_arg("p", "port", "UDP port to receive sensor datagrams on (0 for simulated input)", false, 0, "non-negative integer");
+    TCLAP::ValueArg<uint16_t> recv_batch_arg("", "recv_batch", "Datagrams taken per receive call (1-1024)", false, 64, "positive integer");
+    TCLAP::ValueArg<double> rate_arg("", "rate", "Offered load: datagrams per second, open loop, with the compare model only (0 for as fast as possible)", false, 0.0, "non-negative real number");
+    TCLAP::ValueArg<std::string> arrivals_arg("", "arrivals", "Arrival process for rate (fixed, poisson)", false, "poisson", "process name");
+    TCLAP::ValueArg<std::string> recv_backend_arg("", "recv_backend", "UDP receive backend (auto, io_uring, recvmmsg)", false, "auto", "backend name");
+
+    TCLAP::SwitchArg simulate_weights_arg("i", "sim_weights", "Simulate weights", false);
+    TCLAP::ValueArg<std::string> weights_file_arg("w", "weights_file", "Path to weights file", false, "", "valid file path (relative or absolute)");
+    TCLAP::ValueArg<uint32_t> weights_granularity_arg("g", "weights_div", "Divider for simulated weights", false, 1024, "positive integer");
+    TCLAP::ValueArg<float> weights_min_arg("m", "weights_min", "Minimum simulated weight", false, -1.0, "real number");
+    TCLAP::ValueArg<float> weights_max_arg("n", "weights_max", "Maximum simulated weight", false, 1.0, "real number");
+
+    TCLAP::ValueArg<uint32_t> delay_arg("b", "delay", "Initial delay (ms)", false, 0, "non-negative integer");
+    TCLAP::ValueArg<uint32_t> between_arg("e", "between", "Wait between operations (ms)", false, 100, "non-negative integer");
+    TCLAP::ValueArg<uint32_t> repeats_arg("a", "repeats", "Number of times data set is repeated", false, 1, "non-negative integer");
+    TCLAP::ValueArg<std::string> data_source_arg("u", "source", "Path to a capture file to replay", false, "", "valid file path (relative or absolute)");
+    TCLAP::ValueArg<std::string> record_file_arg("", "record", "Path to a capture file to record the input to", false, "", "valid file path (relative or absolute)");
+    TCLAP::ValueArg<uint32_t> amplitude_granularity_arg("j", "ampl_div", "Divider for simulated amplitudes", false, 1024, "positive integer");
+    TCLAP::ValueArg<float> amplitude_min_arg("q", "ampl_min", "Minimum simulated amplitude", false, -1.0, "real number");
+    TCLAP::ValueArg<float> amplitude_max_arg("x", "ampl_max", "Maximum simulated amplitude", false, 1.0, "real number");
+
+    TCLAP::SwitchArg skip_header_arg("k", "skip_header", "Skip report header line", false);
+    TCLAP::ValueArg<std::string> report_file_arg("y", "report_file", "Path to report file", false, "", "valid file path (relative or absolute), - for cout");
+    TCLAP::ValueArg<std::string> perf_file_arg("f", "perf_file", "Path to report file for perf data", false, "", "valid file path (relative or absolute), - for cout");
+
+    cmd.add(verbosity_arg);
+    cmd.add(task_count_arg);
+    cmd.add(block_size_arg);
+    cmd.add(class_count_arg);
+    cmd.add(kernel_arg);
+    cmd.add(sv_count_arg);
+    cmd.add(gamma_arg);
+    cmd.add(coef0_arg);
+    cmd.add(degree_arg);
+    cmd.add(sensor_count_arg);
+    cmd.add(sample_count_arg);
+    cmd.add(datagram_size_arg);
+    cmd.add(isa_arg);
+    cmd.add(accumulator_arg);
+    cmd.add(early_exit_arg);
+    cmd.add(generic_length_arg);
+    cmd.add(runner_arg);
+    cmd.add(heap_frames_arg);
+    cmd.add(autotune_arg);
+    cmd.add(autotune_cycles_arg);
+    cmd.add(ingest_batch_arg);
+    cmd.add(prefetch_distance_arg);
+    cmd.add(suspend_lines_arg);
+    cmd.add(deadline_us_arg);
+    cmd.add(alarm_deadline_us_arg);
+    cmd.add(exec_model_arg);
+    cmd.add(thread_count_arg);
+    cmd.add(weights_format_arg);
+    cmd.add(weights_density_arg);
+
+    cmd.add(port_arg);
+    cmd.add(recv_batch_arg);
+    cmd.add(recv_backend_arg);
+    cmd.add(rate_arg);
+    cmd.add(arrivals_arg);
+
+    cmd.add(simulate_weights_arg);
+    cmd.add(weights_file_arg);
+    cmd.add(weights_granularity_arg);
+    cmd.add(weights_min_arg);
+    cmd.add(weights_max_arg);
+
+    cmd.add(delay_arg);
+    cmd.add(between_arg);
+    cmd.add(repeats_arg);
+    cmd.add(data_source_arg);
+    cmd.add(record_file_arg);
+    cmd.add(amplitude_granularity_arg);
+    cmd.add(amplitude_min_arg);
+    cmd.add(amplitude_max_arg);
+
+    cmd.add(skip_header_arg);
+    cmd.add(report_file_arg);
+    cmd.add(perf_file_arg);
+
+    cmd.parse(argc, argv);
+
+    rt.verbosity = verbosity_arg.getValue();
+    rt.task_count = task_count_arg.getValue();
+    rt.block_size = block_size_arg.getValue();
+    rt.class_count = class_count_arg.getValue();
+    rt.kernel_name = kernel_arg.getValue();
+    rt.sv_count = sv_count_arg.getValue();
+    rt.gamma = gamma_arg.getValue();
+    rt.coef0 = coef0_arg.getValue();
+    rt.degree = degree_arg.getValue();
+    rt.sensor_count = sensor_count_arg.getValue();
+    rt.sample_count = sample_count_arg.getValue();
+    rt.datagram_size = datagram_size_arg.getValue();
+    rt.isa_name = isa_arg.getValue();
+    rt.accumulator_name = accumulator_arg.getValue();
+    rt.early_exit = early_exit_arg.getValue();
+    rt.generic_length = generic_length_arg.getValue();
+    rt.runner_name = runner_arg.getValue();
+    rt.heap_frames = heap_frames_arg.getValue();
+    rt.autotune = autotune_arg.getValue();
+    rt.autotune_cycles = autotune_cycles_arg.getValue();
+    rt.ingest_batch = ingest_batch_arg.getValue();
+    rt.prefetch_distance = prefetch_distance_arg.getValue();
+    rt.suspend_lines = suspend_lines_arg.getValue();
+    rt.deadline_us = deadline_us_arg.getValue();
+    rt.alarm_deadline_us = alarm_deadline_us_arg.getValue();
+    rt.compare_model_name = exec_model_arg.getValue();
+    rt.thread_count = thread_count_arg.getValue();
+    rt.weights_format_name = weights_format_arg.getValue();
+    rt.weights_density = weights_density_arg.getValue();
+    rt.port = port_arg.getValue();
+    rt.recv_batch = recv_batch_arg.getValue();
+    rt.recv_backend_name = recv_backend_arg.getValue();
+    rt.rate = rate_arg.getValue();
+    rt.arrivals_name = arrivals_arg.getValue();
+
+    rt.simulate_weights = simulate_weights_arg.getValue();
+    rt.weights_file = weights_file_arg.getValue();
+    rt.weights_bounds = {weights_min_arg.getValue(), 
+      weights_max_arg.getValue(), weights_granularity_arg.getValue()};
+
+    // Transmitted data
+    rt.delay_ms = delay_arg.getValue();
+    rt.between_ms = between_arg.getValue();
+    rt.repeats = repeats_arg.getValue();
+    rt.data_source = data_source_arg.getValue();
+    rt.record_file = record_file_arg.getValue();
+    rt.amplitude_bounds = {amplitude_min_arg.getValue(), 
+      amplitude_max_arg.getValue(), amplitude_granularity_arg.getValue()};
+
+    rt.skip_header = skip_header_arg.getValue();
+    rt.report_file = report_file_arg.getValue();
+    rt.perf_file = perf_file_arg.getValue();
+
+    rt.simulate_amplitudes = rt.simulate_weights && (rt.port == 0) && rt.data_source.empty();
+
+    rt.exec_pattern = EXEC_PATTERN_BOTH;
+    rt.exec_model = EXEC_MODEL_SEQ;
+
+    rt.validate();
+
+    // Under load, each period is scored once, by the model being measured
+    if (rt.rate > 0.0)
+    {
+      rt.exec_pattern = EXEC_PATTERN_CORO;
+      rt.exec_model = rt.compare_model;
+    }
+
+    return true;
+  }
+  catch (const TCLAP::ArgException &e)
+  {
+    std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+    return false;
+  }
+  catch (const std::exception &ex)
+  {
+    std::cerr << "validation error: " << ex.what() << std::endl;
+    return false;
+  }
+}
+
+////////////////////////////////////////////////////////////////
+// Data buffer
+////////////////////////////////////////////////////////////////
+
+/*
+D = datagram size in data bytes
+U = datagram unit count = D/(sizeof(data_item_t) = D/2)
+The shared input buffer [U x N] looks like this:
+
+Note that sensor id (k) & sequence id (s) are 32-bit, whereas
+data points (x) are 16-bit.
+
+-----------------------------------------------------------------
+[0...nk-1 nk nk+1 nk+2     nk+3     nk+4          U-1
+-----------------------------------------------------------------
+[k0,      s0,     x00,     x01,     x02,     ..., x0(U-nk+3) ]
+[k1,      s1,     x10,     x11,     x12,     ..., x1(U-nk+3) ]
+[k2,      s2,     x20,     x21,     x22,     ..., x2(U-nk+3) ]
+[...                                                         ]
+-----------------------------------------------------------------
+
+Each row of width U contains nk cells for a sensor ID,
+two cells for a sequence number and U-(nk+2) cells of data.
+The row is passed as the payload of a single datagram; thus
+recv() can write the content directly to the next available
+row of the buffer.
+
+The buffer can also include a magic value for s:
+(unsigned)(-1). This delivers a single commmand integer (s0)
+as payload.
+
+datagram_t can be used to access a record, e.g.:
+
+  datagram_t* p = (datagram_t*)((char*)vector.data()
+                         + (rt.datagram_size * row_index))
+
+*/
+
+////////////////////////////////////////////////////////////////
+// Weights
+////////////////////////////////////////////////////////////////
+
+/*
+The ID in columns 0-1 is passed to a lookup function which
+executes some pointer chasing to retrieve the address of
+the weights for the specific sensor.
+
+This will be a prime beneficiary of prefetching.
+*/
+
+void create_sensor_ids(const run_time_settings_t &rt, std::vector<bpt_key_t> &sensor_ids)
+{
+  sensor_ids.clear();
+  for (uint32_t i = 0; i < rt.sensor_count; i++)
+  {
+    bpt_key_t key;
+    uuid::generate_uuid_v4_num(key.uid);
+    sensor_ids.push_back(key);
+  }
+}
+
+void create_sensor_btree(const run_time_settings_t &rt, std::vector<bpt_key_t> &sensor_ids,
+  bpt_map_t& map)
+{
+  map.clear();
+  // i is the data -> row number in weights array
+  for (uint32_t i = 0; i < rt.sensor_count; i++) 
+  {
+    map[sensor_ids[i]] = i;
+  }
+}
+
+// The weights are stored in a big array (like a file), and the tree contains
+// an offset in the leaf node.
+// This seems more realistic. It also creates one more "pointer" to chase.
+// Each sensor owns a bank of bank_rows rows of w_len items. For linear
+// SVMs there are class_count rows, each a bias followed by sv_len weights;
+// for kernel SVMs there are sv_count rows, each a dual coefficient 
+// followed by a support vector, and the biases are held separately.
+// Int8 weights are a copy of the linear bank without the biases, with
+// one scale per sensor; the biases keep their full precision.
+
+// Sparse weights are the bands of non-zero weights of each linear
+// model, packed; the bias stays in the dense bank. A sensor with no
+// bands here (is_sparse false) is scored from the dense bank.
+
+struct sparse_weights_t {
+  std::vector<uint8_t> is_sparse; // One per sensor
+  std::vector<uint32_t> band_begin; // sensor_count + 1 offsets into bands
+  std::vector<uint32_t> value_begin; // sensor_count + 1 offsets into values
+  std::vector<svm_band_t> bands;
+  std::vector<data_item_t> values;
+  uint32_t sparse_count = 0;
+};
+
+struct quantized_weights_t {
+  std::vector<int8_t> weights; // q8_bank_len per sensor
+  std::vector<data_item_t> biases; // bank_rows per sensor
+  std::vector<int64_t> scales; // One per sensor
+};
+
+// Simulates band-limited fault signatures: SIM_WEIGHT_BANDS bands at
+// random positions hold about weights_density of the weights of each
+// model, and the rest are zero
+void limit_weights_bands(const run_time_settings_t &rt, std::vector<data_item_t> &weights)
+{
+  std::mt19937 engine; // Mersenne twister MT19937
+  engine.seed(7654);
+  size_t active = std::max<size_t>(SIM_WEIGHT_BANDS, (size_t)(rt.weights_density * rt.sv_len));
+  size_t band_len = std::min<size_t>(rt.sv_len, active / SIM_WEIGHT_BANDS);
+  std::uniform_int_distribution<size_t> start_dist(0, rt.sv_len - band_len);
+  std::vector<uint8_t> keep(rt.sv_len);
+  for (size_t row = 0; row < (size_t)rt.sensor_count * rt.bank_rows; row++)
+  {
+    data_item_t* w = weights.data() + (row * rt.w_len) + 1;
+    std::fill(keep.begin(), keep.end(), 0);
+    for (size_t b = 0; b < SIM_WEIGHT_BANDS; b++)
+    {
+      size_t start = start_dist(engine);
+      std::fill(keep.begin() + start, keep.begin() + start + band_len, 1);
+    }
+    for (size_t i = 0; i < rt.sv_len; i++)
+    {
+      if (!keep[i])
+      {
+        w[i] = data_item_t(0);
+      }
+    }
+  }
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+void populate_weights_simulated(const run_time_settings_t &rt, const std::vector<bpt_key_t> &sensor_ids, std::vector<data_item_t> &weights)
+{
+  std::mt19937 engine; // Mersenne twister MT19937
+  bounded_distribution<data_item_t> distribution(rt.weights_bounds);
+  engine.seed(5432);
+
+  auto rand_weights = [&]() { return distribution(engine); };
+  weights.resize(rt.bank_len * rt.sensor_count);
+  std::generate(weights.begin(), weights.end(), rand_weights);
+  if (rt.weights_density < 1.0f)
+  {
+    limit_weights_bands(rt, weights);
+  }
+  if (rt.verbosity >= 3)
+  {
+    dump_fp_vector(weights, std::cout, "weights");
+  }
+}
+
+void populate_weights_stored(const run_time_settings_t &rt, const std::vector<bpt_key_t> &sensor_ids, std::vector<data_item_t> &weights)
+{
+  // TODO
+}
+#pragma GCC diagnostic pop
+
+void populate_kernel_biases(const run_time_settings_t &rt, std::vector<data_item_t> &biases)
+{
+  std::mt19937 engine; // Mersenne twister MT19937
+  bounded_distribution<data_item_t> distribution(rt.weights_bounds);
+  engine.seed(6543);
+
+  auto rand_biases = [&]() { return distribution(engine); };
+  biases.resize(rt.sensor_count);
+  std::generate(biases.begin(), biases.end(), rand_biases);
+}
+
+void quantize_weights(const run_time_settings_t &rt, const std::vector<data_item_t> &weights, quantized_weights_t &quantized)
+{
+  quantized.weights.resize((size_t)rt.q8_bank_len * rt.sensor_count);
+  quantized.biases.resize((size_t)rt.bank_rows * rt.sensor_count);
+  quantized.scales.resize(rt.sensor_count);
+  for (size_t i = 0; i < rt.sensor_count; i++)
+  {
+    const data_item_t* bank = weights.data() + (rt.bank_len * i);
+    int32_t max_abs = 0;
+    for (size_t k = 0; k < rt.bank_rows; k++)
+    {
+      max_abs = std::max(max_abs, svm_max_abs_raw(bank + (k * rt.w_len) + 1, rt.sv_len));
+    }
+    int64_t scale = svm_q8_scale(max_abs);
+    quantized.scales[i] = scale;
+    for (size_t k = 0; k < rt.bank_rows; k++)
+    {
+      quantized.biases[(i * rt.bank_rows) + k] = bank[k * rt.w_len];
+      svm_quantize_q8(bank + (k * rt.w_len) + 1, rt.sv_len, scale, 
+        quantized.weights.data() + (rt.q8_bank_len * i) + (rt.sv_len * k));
+    }
+  }
+}
+
+void compress_weights(const run_time_settings_t &rt, const std::vector<data_item_t> &weights, sparse_weights_t &sparse)
+{
+  sparse = sparse_weights_t();
+  sparse.is_sparse.resize(rt.sensor_count);
+  sparse.band_begin.push_back(0);
+  sparse.value_begin.push_back(0);
+  for (size_t i = 0; i < rt.sensor_count; i++)
+  {
+    const data_item_t* w = weights.data() + (rt.bank_len * i) + 1;
+    size_t band_count = svm_find_bands(w, rt.sv_len, SVM_BAND_MIN_GAP, sparse.bands, sparse.values);
+    size_t items = svm_band_items(sparse.bands.data() + sparse.band_begin.back(), band_count);
+    bool use = (rt.weights_format == WEIGHTS_SPARSE) 
+      || ((float)items <= SPARSE_MAX_DENSITY * (float)rt.sv_len);
+    if (!use)
+    {
+      sparse.bands.resize(sparse.band_begin.back());
+      sparse.values.resize(sparse.value_begin.back());
+    }
+    sparse.is_sparse[i] = use ? 1 : 0;
+    sparse.sparse_count += use ? 1 : 0;
+    sparse.band_begin.push_back((uint32_t)sparse.bands.size());
+    sparse.value_begin.push_back((uint32_t)sparse.values.size());
+  }
+}
+
+void populate_weights(const run_time_settings_t &rt, const std::vector<bpt_key_t> &sensor_ids, std::vector<data_item_t> &weights,
+  quantized_weights_t &quantized, sparse_weights_t &sparse)
+{
+  if (rt.simulate_weights)
+  {
+    populate_weights_simulated(rt, sensor_ids, weights);
+  }
+  else
+  {
+    populate_weights_stored(rt, sensor_ids, weights);
+  }
+  if (rt.weights_format == WEIGHTS_INT8)
+  {
+    quantize_weights(rt, weights, quantized);
+  }
+  if (rt.weights_format == WEIGHTS_SPARSE || rt.weights_format == WEIGHTS_AUTO)
+  {
+    compress_weights(rt, weights, sparse);
+  }
+}
+
+////////////////////////////////////////////////////////////////
+// Runtime data
+////////////////////////////////////////////////////////////////
+
+class runtime_data
+{
+public:
+  runtime_data(const run_time_settings_t &rt_)
+      : rt(rt_)
+  {
+    #if MEASURE_LOCALITY==1
+    locality_filestream.open("locality.csv", 
+          std::ofstream::out | std::ofstream::app);
+    #endif
+  }
+
+  // Fixed input data
+  const run_time_settings_t &rt;
+  std::vector<bpt_key_t> source_sensor_ids;
+  bpt_map_t weights_map;
+
+  // Weights - calculated once only
+  std::vector<data_item_t> weights;
+  // Int8 weights; the 16-bit weights are kept to check their accuracy
+  quantized_weights_t weights_q8;
+  uint64_t q8_agreed = 0;
+  uint64_t q8_checked = 0;
+  // Banded weights, for some or all sensors
+  sparse_weights_t weights_sparse;
+
+  // Kernel SVMs: bias per sensor, |s|^2 per support vector
+  svm_kernel_evaluator<data_item_t> kernel_eval;
+  std::vector<data_item_t> kernel_biases;
+  std::vector<int64_t> sv_norms;
+
+  // Early exit: bin order and suffix bounds per sensor, and the 
+  // number of bins read over the number of bins scored
+  std::vector<uint16_t> bin_order;
+  std::vector<int64_t> exit_bounds;
+  std::atomic<uint64_t> bins_touched { 0 };
+  std::atomic<uint64_t> bins_scored { 0 };
+
+  // Kernels chosen at startup: a raw kernel, or else an 
+  // instantiation of the generic template
+  typedef bool (*svm_infer_fn_t)(const data_item_t*, const data_item_t*, data_item_t, size_t);
+  typedef uint32_t (*svm_infer_block_fn_t)(const data_item_t*, const data_item_t*, size_t, size_t, data_item_t, size_t);
+  typedef size_t (*svm_infer_argmax_fn_t)(const data_item_t*, size_t, size_t, const data_item_t*, size_t);
+  svm_dot_fn_t dot_kernel = nullptr;
+  svm_dot_fn_t dot_row_kernel = nullptr; // Whole rows only: may be specialised for sv_len
+  svm_dot_block_fn_t dot_block_kernel = nullptr;
+  svm_dot_q8_fn_t dot_q8_kernel = nullptr;
+  svm_infer_fn_t generic_kernel = nullptr;
+  svm_infer_block_fn_t generic_block_kernel = nullptr;
+  svm_infer_argmax_fn_t generic_argmax_kernel = nullptr;
+
+  // Dynamic data
+  std::vector<data_vector_t> sensor_data;
+  std::vector<id_t> seq_ids;
+  std::vector<result_vector_t> results;
+  // When each sensor's latest sample was saved (deadline_clock_ns()),
+  // for EXEC_MODEL_DEADLINE only; 0 if none this period
+  std::vector<uint64_t> ready_at;
+
+  // Output
+  std::ofstream report_filestream;
+  std::ofstream perf_filestream;
+  #if MEASURE_LOCALITY==1
+  std::ofstream locality_filestream;
+  #endif
+
+  void initialise()
+  {
+    // Prepare work areas
+    create_sensor_ids(rt, source_sensor_ids);
+    create_sensor_btree(rt, source_sensor_ids, weights_map);
+
+    // The sequence ID of each sensor tells us how many samples
+    // have been received for that sensor so far
+    seq_ids.resize(rt.sensor_count);
+    std::fill(seq_ids.begin(), seq_ids.end(), 0);
+    if (rt.compare_model == EXEC_MODEL_DEADLINE)
+    {
+      ready_at.assign(rt.sensor_count, 0);
+    }
+
+    // The input data for each sensor is held in a continuous 
+    // block of sample_count rows, each of width sv_len
+    sensor_data.resize(rt.sensor_count);
+    for (auto& v: sensor_data) {
+      v.resize(rt.sample_count * rt.sv_len);
+    }
+
+    // There is one result for each sample of each sensor
+    results.resize(rt.sensor_count);
+    for (auto& v : results) {
+      v.resize(rt.sample_count);
+      std::fill(v.begin(), v.end(), false);
+    }
+
+    // Populate weights from storage or simulation
+    populate_weights(rt, source_sensor_ids, weights, weights_q8, weights_sparse);
+
+    dot_kernel = svm_dot_kernel(rt.isa);
+    dot_row_kernel = rt.fixed_length ? svm_dot_kernel_for_length(rt.isa, rt.sv_len) : dot_kernel;
+    dot_block_kernel = svm_dot_block_kernel(rt.isa);
+    dot_q8_kernel = svm_dot_q8_kernel(rt.isa);
+    if (rt.kernel_type != SVM_KERNEL_LINEAR)
+    {
+      initialise_kernel_model();
+    }
+    if (rt.early_exit)
+    {
+      initialise_early_exit();
+    }
+    switch (rt.accumulator)
+    {
+    case ACCUM_NARROW:
+      generic_kernel = svm_infer<data_item_t, narrow_accumulator>;
+      generic_block_kernel = svm_infer_block<data_item_t, narrow_accumulator>;
+      generic_argmax_kernel = svm_infer_argmax<data_item_t, narrow_accumulator>;
+      break;
+    case ACCUM_WIDE32:
+      generic_kernel = svm_infer<data_item_t, wide_accumulator<int32_t> >;
+      generic_block_kernel = svm_infer_block<data_item_t, wide_accumulator<int32_t> >;
+      generic_argmax_kernel = svm_infer_argmax<data_item_t, wide_accumulator<int32_t> >;
+      break;
+    default:
+      generic_kernel = svm_infer<data_item_t, wide_accumulator<int64_t> >;
+      generic_block_kernel = svm_infer_block<data_item_t, wide_accumulator<int64_t> >;
+      generic_argmax_kernel = svm_infer_argmax<data_item_t, wide_accumulator<int64_t> >;
+      break;
+    }
+  }
+
+  void initialise_kernel_model()
+  {
+    svm_kernel_params<data_item_t> params = { rt.kernel_type, 
+      from_float<data_item_t>(rt.gamma), from_float<data_item_t>(rt.coef0), rt.degree };
+    // The generic ISA has no raw kernel, so uses the scalar one
+    kernel_eval = svm_kernel_evaluator<data_item_t>(params, dot_row_kernel);
+    populate_kernel_biases(rt, kernel_biases);
+    sv_norms.resize((size_t)rt.sensor_count * rt.sv_count);
+    for (size_t j = 0; j < sv_norms.size(); j++)
+    {
+      sv_norms[j] = kernel_eval.norm(weights.data() + (j * rt.w_len) + 1, rt.sv_len);
+    }
+  }
+
+  // Sorts the weights of each sensor by decreasing magnitude and 
+  // records the order, so that samples can be permuted to match
+  void initialise_early_exit()
+  {
+    int64_t x_bound = (int64_t)1 << 15; // Any 16-bit value
+    if (rt.simulate_amplitudes)
+    {
+      x_bound = std::max(
+        std::abs((int64_t)svm_fixed_traits<data_item_t>::raw(from_float<data_item_t>(rt.amplitude_bounds.min_value))),
+        std::abs((int64_t)svm_fixed_traits<data_item_t>::raw(from_float<data_item_t>(rt.amplitude_bounds.max_value))));
+    }
+    bin_order.resize((size_t)rt.sensor_count * rt.sv_len);
+    exit_bounds.resize((size_t)rt.sensor_count * rt.exit_bounds_len);
+    std::vector<data_item_t> sorted(rt.sv_len);
+    for (size_t i = 0; i < rt.sensor_count; i++)
+    {
+      data_item_t* w = weights.data() + (rt.bank_len * i) + 1;
+      uint16_t* order = bin_order.data() + (rt.sv_len * i);
+      svm_magnitude_order(w, rt.sv_len, order);
+      for (size_t k = 0; k < rt.sv_len; k++)
+      {
+        sorted[k] = w[order[k]];
+      }
+      std::copy(sorted.begin(), sorted.end(), w);
+      svm_suffix_bounds(w, rt.sv_len, x_bound, rt.exit_chunk, 
+        exit_bounds.data() + (rt.exit_bounds_len * i));
+    }
+  }
+
+  inline const data_vector_t& resolve_x_vec(uint32_t sensor_index) const
+  {
+    return sensor_data[sensor_index];
+  }
+  inline const data_item_t *resolve_w(bpt_data_t sensor_index) const
+  {
+    return weights.data() + (rt.bank_len * sensor_index);
+  }
+  // Inverse of resolve_w()
+  inline bpt_data_t bank_index(const data_item_t* bank) const
+  {
+    return (bpt_data_t)((bank - weights.data()) / rt.bank_len);
+  }
+  inline const int8_t *resolve_w_q8(bpt_data_t sensor_index) const
+  {
+    return weights_q8.weights.data() + ((size_t)rt.q8_bank_len * sensor_index);
+  }
+  inline const data_item_t *resolve_biases_q8(bpt_data_t sensor_index) const
+  {
+    return weights_q8.biases.data() + ((size_t)rt.bank_rows * sensor_index);
+  }
+  inline bool is_sparse(bpt_data_t sensor_index) const
+  {
+    return !weights_sparse.is_sparse.empty() && weights_sparse.is_sparse[sensor_index];
+  }
+  inline const svm_band_t *resolve_bands(bpt_data_t sensor_index, size_t& band_count) const
+  {
+    uint32_t begin = weights_sparse.band_begin[sensor_index];
+    band_count = weights_sparse.band_begin[sensor_index + 1] - begin;
+    return weights_sparse.bands.data() + begin;
+  }
+  inline const data_item_t *resolve_sparse_values(bpt_data_t sensor_index, size_t& value_count) const
+  {
+    uint32_t begin = weights_sparse.value_begin[sensor_index];
+    value_count = weights_sparse.value_begin[sensor_index + 1] - begin;
+    return weights_sparse.values.data() + begin;
+  }
+  inline bool infer(const data_item_t* w, const data_item_t* x, data_item_t bias) const
+  {
+    if (dot_row_kernel)
+    {
+      return svm_infer_raw(dot_row_kernel, w, x, bias, rt.sv_len);
+    }
+    return generic_kernel(w, x, bias, rt.sv_len);
+  }
+  // Scores one sample row against a bank of one-vs-rest models
+  inline result_t infer_classes(const data_item_t* bank, const data_item_t* x) const
+  {
+    if (dot_block_kernel)
+    {
+      return (result_t)svm_infer_raw_argmax(dot_block_kernel, bank, rt.w_len, rt.class_count, x, rt.sv_len);
+    }
+    return (result_t)generic_argmax_kernel(bank, rt.w_len, rt.class_count, x, rt.sv_len);
+  }
+  // Scores rows consecutive sample rows against the model bank of one 
+  // sensor; the result is the decision (one class) or the class label
+  inline void infer_rows(const data_item_t* bank, const data_item_t* x, size_t rows, result_t* results)
+  {
+    if (rt.weights_format == WEIGHTS_INT8)
+    {
+      infer_rows_q8(bank_index(bank), x, rows, results);
+      return;
+    }
+    if (is_sparse(bank_index(bank)))
+    {
+      infer_rows_sparse(bank, x, rows, results);
+      return;
+    }
+    if (rt.early_exit)
+    {
+      *results = infer_early_exit(bank, x) ? 1 : 0;
+      return;
+    }
+    if (rt.class_count > 1)
+    {
+      for (size_t r = 0; r < rows; r++)
+      {
+        results[r] = infer_classes(bank, x + (r * rt.sv_len));
+      }
+      return;
+    }
+    data_item_t bias = bank[0];
+    const data_item_t* w = bank + 1;
+    if (rows == 1)
+    {
+      *results = infer(w, x, bias) ? 1 : 0;
+      return;
+    }
+    uint32_t decisions = dot_block_kernel
+      ? svm_infer_raw_block(dot_block_kernel, w, x, rt.sv_len, rows, bias, rt.sv_len)
+      : generic_block_kernel(w, x, rt.sv_len, rows, bias, rt.sv_len);
+    for (size_t r = 0; r < rows; r++)
+    {
+      results[r] = (decisions >> r) & 1;
+    }
+  }
+  inline void infer_rows_q8(bpt_data_t sensor_index, const data_item_t* x, size_t rows, result_t* results) const
+  {
+    const int8_t* bank = resolve_w_q8(sensor_index);
+    const data_item_t* biases = resolve_biases_q8(sensor_index);
+    int64_t scale = weights_q8.scales[sensor_index];
+    for (size_t r = 0; r < rows; r++, x += rt.sv_len)
+    {
+      results[r] = (rt.class_count > 1)
+        ? (result_t)svm_infer_q8_argmax(dot_q8_kernel, bank, rt.sv_len, scale, biases, rt.class_count, x, rt.sv_len)
+        : (svm_infer_q8(dot_q8_kernel, bank, scale, x, biases[0], rt.sv_len) ? 1 : 0);
+    }
+  }
+  inline void infer_rows_sparse(const data_item_t* bank, const data_item_t* x, size_t rows, result_t* results) const
+  {
+    size_t band_count, value_count;
+    bpt_data_t sensor_index = bank_index(bank);
+    const svm_band_t* bands = resolve_bands(sensor_index, band_count);
+    const data_item_t* values = resolve_sparse_values(sensor_index, value_count);
+    svm_dot_fn_t dot = dot_kernel ? dot_kernel : svm_dot_scalar;
+    for (size_t r = 0; r < rows; r++, x += rt.sv_len)
+    {
+      results[r] = svm_infer_bands(dot, bands, band_count, values, x, bank[0]) ? 1 : 0;
+    }
+  }
+  // Rescores every sample with the 16-bit weights and counts the 
+  // results of the int8 weights that agree
+  void check_q8_accuracy()
+  {
+    svm_dot_fn_t dot = dot_kernel ? dot_kernel : svm_dot_scalar;
+    svm_dot_block_fn_t dot_block = dot_block_kernel ? dot_block_kernel : svm_dot_block<svm_block_scalar>;
+    for (bpt_data_t i = 0; i < rt.sensor_count; i++)
+    {
+      const data_item_t* bank = resolve_w(i);
+      const data_item_t* x = sensor_data[i].data();
+      for (size_t sample = 0; sample < rt.sample_count; sample++, x += rt.sv_len)
+      {
+        result_t expected = (rt.class_count > 1)
+          ? (result_t)svm_infer_raw_argmax(dot_block, bank, rt.w_len, rt.class_count, x, rt.sv_len)
+          : (svm_infer_raw(dot, bank + 1, x, bank[0], rt.sv_len) ? 1 : 0);
+        q8_agreed += (results[i][sample] == expected) ? 1 : 0;
+        q8_checked++;
+      }
+    }
+  }
+  inline float q8_agreement() const
+  {
+    return q8_checked ? (float)q8_agreed / (float)q8_checked : 1.0f;
+  }
+  // Scores one sample row, reading only as many bins as it needs
+  inline bool infer_early_exit(const data_item_t* bank, const data_item_t* x)
+  {
+    bpt_data_t sensor_index = bank_index(bank);
+    size_t touched;
+    bool decision = svm_infer_raw_early_exit(dot_kernel ? dot_kernel : svm_dot_scalar, 
+      bank + 1, x, bank[0], rt.sv_len, resolve_exit_bounds(sensor_index), rt.exit_chunk, touched);
+    bins_touched.fetch_add(touched, std::memory_order_relaxed);
+    bins_scored.fetch_add(rt.sv_len, std::memory_order_relaxed);
+    return decision;
+  }
+  inline const int64_t *resolve_exit_bounds(bpt_data_t sensor_index) const
+  {
+    return exit_bounds.data() + ((size_t)rt.exit_bounds_len * sensor_index);
+  }
+  inline float touched_fraction() const
+  {
+    return bins_scored ? (float)bins_touched / (float)bins_scored : 1.0f;
+  }
+  inline const int64_t *resolve_sv_norms(bpt_data_t sensor_index) const
+  {
+    return sv_norms.data() + ((size_t)rt.sv_count * sensor_index);
+  }
+  inline result_vector_t& resolve_results_vec(uint32_t sensor_index)
+  {
+    return results[sensor_index];
+  }
+  // PRIORITY_CLASS_ALARM if the sensor's latest sample scored positive
+  inline int priority_class(uint32_t sensor_index) const
+  {
+    const result_vector_t& r = results[sensor_index];
+    return (!r.empty() && r.back() != 0) ? PRIORITY_CLASS_ALARM : PRIORITY_CLASS_NORMAL;
+  }
+  inline bool check_sensor_index(bpt_data_t sensor_index) const
+  {
+    if (sensor_index >= rt.sensor_count)
+    {
+      std::cerr << "Internal error: sensor id " << sensor_index << " is out of range" << std::endl;
+      return false;
+    }
+    return true;
+  }
+  inline bool update_seq_id(bpt_data_t sensor_index, uint32_t seq_id, bool update)
+  {
+    uint32_t current_id = seq_ids[sensor_index];
+    if (seq_id != current_id)
+    {
+      std::cerr << "Data error: sensor index " << sensor_index
+                << " got seq_id " << seq_id
+                << "; expected " << current_id << std::endl;
+      return false;
+    }
+    if (update) {
+      seq_ids[sensor_index]++;
+    }
+    return true;
+  }
+  // Why a capture cannot be replayed against these weights, or empty if it can
+  std::string capture_mismatch(const capture_file& capture) const
+  {
+    const capture_header_t& h = capture.header();
+    if (h.datagram_size != rt.datagram_size)
+    {
+      return "datagram size is " + std::to_string(h.datagram_size);
+    }
+    if (h.sample_count > rt.sample_count)
+    {
+      return "sample count is " + std::to_string(h.sample_count);
+    }
+    for (uint32_t i = 0; i < h.sensor_count; i++)
+    {
+      bpt_key_t key;
+      memcpy(key.uid, capture.sensor_id(i), sizeof(key.uid));
+      if (weights_map.find(key) == weights_map.end())
+      {
+        return "sensor " + std::to_string(i) + " has no weights";
+      }
+    }
+    return std::string();
+  }
+  // The row of sensor_data a datagram's payload belongs in, once its
+  // header has been checked; nullptr if the header is not valid
+  data_item_t* input_row(const datagram_t& header)
+  {
+    // Find sensor index from UUID
+    auto itF = weights_map.find(header.sensor_id);
+    uint32_t sensor_index = itF == weights_map.end() ? (uint32_t)-1 : itF->second;
+    return input_row(sensor_index, header);
+  }
+  // As input_row(header), for a sensor already looked up
+  data_item_t* input_row(uint32_t sensor_index, const datagram_t& header)
+  {
+    // Check data integrity & Match sequence IDs
+    if (!check_sensor_index(sensor_index) 
+      || header.seq_id >= rt.sample_count
+      || !update_seq_id(sensor_index, header.seq_id, true))
+    {
+      return nullptr;
+    }
+    if (!ready_at.empty())
+    {
+      ready_at[sensor_index] = deadline_clock_ns();
+    }
+    // The correct row of the sensor's block
+    return sensor_data[sensor_index].data() + (header.seq_id * rt.sv_len);
+  }
+  bool save_input_data(const std::vector<data_item_t>& buffer)
+  {
+    const datagram_t *row_ptr = (const datagram_t *)buffer.data();
+    data_item_t* row = input_row(*row_ptr);
+    if (row)
+    {
+      // Copy the SVM into the row
+      std::copy(row_ptr->data, row_ptr->data + rt.sv_len, row);
+    }
+    return row != nullptr;
+  } 
+  void reset_seq_ids() {
+    std::fill(seq_ids.begin(), seq_ids.end(), 0);
+    std::fill(ready_at.begin(), ready_at.end(), 0);
+  }
+  // Bytes a run touches: the samples, weights and results of the 
+  // sensors that have had input
+  uint64_t working_set_bytes() const {
+    uint64_t active = std::count_if(seq_ids.begin(), seq_ids.end(), [](id_t id) { return id > 0; });
+    return active * (((uint64_t)rt.sample_count * rt.sv_len + rt.bank_len) * sizeof(data_item_t) 
+      + (uint64_t)rt.sample_count * sizeof(result_t));
+  }
+};
+
+
+////////////////////////////////////////////////////////////////
+// Performance event monitoring 
+////////////////////////////////////////////////////////////////
+
+#include <perf/perf_rec.h>
+#include <perf/pe_summaries.h>
+
+pem_test pem_summaries[EMI_COUNT];
+long long pem_data[PEM_MAX_EVENTS];
+int pem_statistic_count = 0;
+intmax_t pem_duration;
+
+void pem_init(int which_setup)
+{
+  pem_statistic_count = pem_setup(which_setup);
+  ::pe_summaries_init(pem_statistic_count, pem_summaries);
+}
 
-    cmd.parse(argc, argv);
+template <typename FP_T>
+void perf_record(size_t which_summary, FP_T fn) {
+  ::perf_record(true, pem_summaries + which_summary, pem_duration, pem_data, fn);
+}
 
-    rt.verbosity = verbosity_arg.getValue();
-    rt.task_count = task_count_arg.getValue();
-    rt.sensor_count = sensor_count_arg.getValue();
-    rt.sample_count = sample_count_arg.getValue();
-    rt.datagram_size = datagram_size_arg.getValue();
-    // rt.port_num = port_num_arg.getValue();
+void perf_report(std::ostream* os, int which_summary)
+{
+  if (os) {
+    const pem_test* p = pem_summaries + which_summary;
+    const char** names = pe_summary_get_names();
+    *os << setw(9) << names[which_summary] << " pe stats : ";
+    for (int i = 0; i < pem_statistic_count; i++) {
+      *os << p->descriptors[i].name << "," << p->extract_value(i) << ",";
+    }
+    *os << std::endl;
+  }
+}
 
-    rt.simulate_weights = simulate_weights_arg.getValue();
-    rt.weights_file = weights_file_arg.getValue();
-    rt.weights_bounds = {weights_min_arg.getValue(), 
-      weights_max_arg.getValue(), weights_granularity_arg.getValue()};
+////////////////////////////////////////////////////////////////
+// Locality
+////////////////////////////////////////////////////////////////
 
-    // Transmitted data
-    rt.delay_ms = delay_arg.getValue();
-    rt.between_ms = between_arg.getValue();
-    rt.repeats = repeats_arg.getValue();
-    rt.data_source = data_source_arg.getValue();
-    rt.amplitude_bounds = {amplitude_min_arg.getValue(), 
-      amplitude_max_arg.getValue(), amplitude_granularity_arg.getValue()};
+#if MEASURE_LOCALITY==1
+// This code records the addresses of consecutive nodes found in the tree
+// and calculates the locality of the jumps between them
+std::vector<long long> locality_jumps;
+void record_locality(const void* n, const void* nprev)
+{ 
+  const char* pnp = static_cast<const char*>(nprev);
+  const char* pn = static_cast<const char*>(n);
+  locality_jumps.push_back(pn - pnp);
+}
+void clear_locality()
+{
+  locality_jumps.clear();
+}
+void report_locality(runtime_data& rt_data)
+{
+  std::ostream& os = rt_data.locality_filestream;
+  for (size_t i = 0; i < locality_jumps.size(); i++)
+  {
+    if (i > 0) {
+      os << ",";
+    }
+    os << locality_jumps[i];
+  }
+  os << std::endl;
+}
+#endif
 
-    rt.skip_header = skip_header_arg.getValue();
-    rt.report_file = report_file_arg.getValue();
-    rt.perf_file = perf_file_arg.getValue();
+////////////////////////////////////////////////////////////////
+// SVM processing (coroutine)
+////////////////////////////////////////////////////////////////
 
-    rt.simulate_amplitudes = rt.simulate_weights;
+// Sinks for prefetch results; per thread, as every worker writes them
+thread_local const char *x_next, *w_next;
+thread_local char* result_next;
 
-    rt.exec_pattern = EXEC_PATTERN_BOTH;
-    rt.exec_model = EXEC_MODEL_SEQ;
+// Prefetches the lines spanned by a range that need not be line aligned
+template <typename PREFETCHER_T>
+static const char* prefetch_range(const PREFETCHER_T &prefetcher, const void* ptr, size_t bytes)
+{
+  const char* first = to_pf_line_base(ptr);
+  const char* end = reinterpret_cast<const char*>(ptr) + bytes;
+  return prefetcher.prefetch(first, to_pf_line_count(end - first));
+}
 
-    rt.validate();
+// As prefetch_range, for lines about to be written
+template <typename PREFETCHER_T>
+static char* prefetchw_range(const PREFETCHER_T &prefetcher, void* ptr, size_t bytes)
+{
+  char* first = const_cast<char*>(to_pf_line_base(ptr));
+  char* end = reinterpret_cast<char*>(ptr) + bytes;
+  return prefetcher.prefetchw(first, to_pf_line_count(end - first));
+}
 
-    return true;
+// Prefetches what scoring a sensor reads besides its sample rows: its
+// weights, in whichever format they are stored, and its early exit 
+// bounds
+template <typename PREFETCHER_T>
+static const char* prefetch_weights(const PREFETCHER_T &prefetcher, const runtime_data &rt_data,
+                                    bpt_data_t sensor_index)
+{
+  const run_time_settings_t& rt = rt_data.rt;
+  const data_item_t* w = rt_data.resolve_w(sensor_index);
+  const char* next;
+  if (rt.weights_format == WEIGHTS_INT8)
+  {
+    // Int8 weights take half the lines; the biases take one more
+    next = prefetcher.prefetch(reinterpret_cast<const char*>(rt_data.resolve_w_q8(sensor_index)),
+      to_pf_line_count(rt.q8_bank_len));
+    prefetcher.prefetch(reinterpret_cast<const char*>(rt_data.resolve_biases_q8(sensor_index)),
+      to_pf_line_count(rt.bank_rows * sizeof(data_item_t)));
   }
-  catch (const TCLAP::ArgException &e)
+  else if (rt_data.is_sparse(sensor_index))
   {
-    std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
-    return false;
+    // The bias, then the bands and their weights
+    size_t band_count, value_count;
+    const svm_band_t* bands = rt_data.resolve_bands(sensor_index, band_count);
+    const data_item_t* values = rt_data.resolve_sparse_values(sensor_index, value_count);
+    prefetcher.prefetch(reinterpret_cast<const char*>(w), 1);
+    prefetch_range(prefetcher, bands, band_count * sizeof(svm_band_t));
+    next = prefetch_range(prefetcher, values, value_count * sizeof(data_item_t));
   }
-  catch (const std::exception &ex)
+  else
   {
-    std::cerr << "validation error: " << ex.what() << std::endl;
-    return false;
+    // The whole model bank (class_count rows of bias & weights)
+    next = prefetcher.prefetch(reinterpret_cast<const char*>(w), 
+      to_pf_line_count(rt.bank_len * sizeof(data_item_t)));
+  }
+  if (rt.early_exit)
+  {
+    prefetcher.prefetch(reinterpret_cast<const char*>(rt_data.resolve_exit_bounds(sensor_index)),
+      to_pf_line_count(rt.exit_bounds_len * sizeof(int64_t)));
   }
+  return next;
 }
 
-////////////////////////////////////////////////////////////////
-// Data buffer
-////////////////////////////////////////////////////////////////
+// Prefetches the lines of a sample row read by a list of bands, once each
+template <typename PREFETCHER_T>
+static const char* prefetch_bands(const PREFETCHER_T &prefetcher, const data_item_t* x,
+                                  const svm_band_t* bands, size_t band_count)
+{
+  const char* next = nullptr; // First line not yet prefetched
+  for (size_t b = 0; b < band_count; b++)
+  {
+    const char* first = to_pf_line_base(x + bands[b].start);
+    const char* end = reinterpret_cast<const char*>(x + bands[b].start + bands[b].length);
+    if (next > first)
+    {
+      first = next;
+    }
+    if (first < end)
+    {
+      next = prefetcher.prefetch(first, to_pf_line_count(end - first));
+    }
+  }
+  return next;
+}
 
-/*
-D = datagram size in data bytes
-U = datagram unit count = D/(sizeof(data_item_t) = D/2)
-The shared input buffer [U x N] looks like this:
+// Rows prefetched together: as many whole row blocks as fit in
+// suspend_lines, or one block, prefetched in several chunks
+static size_t prefetch_group_rows(const run_time_settings_t& rt)
+{
+  size_t block_lines = to_pf_line_count(rt.sv_len * sizeof(data_item_t) * rt.block_size);
+  return rt.block_size * std::max<size_t>(1, rt.suspend_lines / block_lines);
+}
 
-Note that sensor id (k) & sequence id (s) are 32-bit, whereas
-data points (x) are 16-bit.
+// TASK_T is resumable (each suspension returns to the runner) or
+// symmetric_task (each suspension passes straight to the next task)
+template <typename PREFETCHER_T, typename TASK_T = resumable>
+static TASK_T infer_sensor_coro(const PREFETCHER_T &prefetcher, runtime_data &rt_data,
+                                size_t coroutine_index)
+{
+  typedef typename coro_task_traits<TASK_T, PREFETCHER_T>::yield_type yield_t;
+  bpt_data_t sensor_index = (bpt_data_t)coroutine_index;
+  co_await yield_t(prefetcher);
 
------------------------------------------------------------------
-[0...nk-1 nk nk+1 nk+2     nk+3     nk+4          U-1
------------------------------------------------------------------
-[k0,      s0,     x00,     x01,     x02,     ..., x0(U-nk+3) ]
-[k1,      s1,     x10,     x11,     x12,     ..., x1(U-nk+3) ]
-[k2,      s2,     x20,     x21,     x22,     ..., x2(U-nk+3) ]
-[...                                                         ]
------------------------------------------------------------------
+  const data_item_t *x, *w;
 
-Each row of width U contains nk cells for a sensor ID,
-two cells for a sequence number and U-(nk+2) cells of data.
-The row is passed as the payload of a single datagram; thus
-recv() can write the content directly to the next available
-row of the buffer.
+  // Resolve weights & bias for this sensor
+  w = rt_data.resolve_w(sensor_index);
+  w_next = prefetch_weights(prefetcher, rt_data, sensor_index);
+  co_await yield_t(prefetcher);
 
-The buffer can also include a magic value for s:
-(unsigned)(-1). This delivers a single commmand integer (s0)
-as payload.
+  // Get sensor data base
+  const data_vector_t& x_vec = rt_data.resolve_x_vec(sensor_index);
+  x = x_vec.data();
+  auto row_len = rt_data.rt.sv_len;
+  auto sample_count = x_vec.size() / row_len;
+  size_t block_size = rt_data.rt.block_size;
+  size_t data_size = row_len * sizeof(data_item_t);
 
-datagram_t can be used to access a record, e.g.:
+  // Get result base
+  size_t results_size = sample_count * sizeof(result_t);
+  size_t results_line_count = to_pf_line_count(results_size);
+  result_vector_t& results = rt_data.resolve_results_vec(sensor_index);
+  result_t* result_ptr = results.data();
+  result_next = prefetcher.prefetchw(reinterpret_cast<char*>(result_ptr), results_line_count);
+  // TODO? do the output prefetch on a per-item basis inside the loop?
 
-  datagram_t* p = (datagram_t*)((char*)vector.data()
-                         + (rt.datagram_size * row_index))
+  // Sparse sensors read, and so prefetch, only the lines of their bands
+  size_t band_count = 0;
+  const svm_band_t* bands = rt_data.is_sparse(sensor_index) 
+    ? rt_data.resolve_bands(sensor_index, band_count) : nullptr;
+  if (bands)
+  {
+    for (uint32_t sample = 0; sample < sample_count; 
+        sample += block_size, x += row_len * block_size, result_ptr += block_size)
+    {
+      size_t rows = std::min<size_t>(block_size, sample_count - sample);
+      for (size_t r = 0; r < rows; r++)
+      {
+        x_next = prefetch_bands(prefetcher, x + (r * row_len), bands, band_count);
+      }
+      co_await yield_t(prefetcher);
+      rt_data.infer_rows(w, x, rows, result_ptr);
+    }
+    co_return;
+  }
 
-*/
+  // Each suspension prefetches at most suspend_lines lines: as many
+  // whole row blocks as fit, or one block in several chunks
+  size_t suspend_lines = rt_data.rt.suspend_lines;
+  size_t group_rows = prefetch_group_rows(rt_data.rt);
+  for (uint32_t sample = 0; sample < sample_count; sample += group_rows)
+  {
+    size_t rows = std::min<size_t>(group_rows, sample_count - sample);
+    const char* next = reinterpret_cast<const char*>(x);
+    size_t lines = to_pf_line_count(data_size * rows);
+    for (; lines > suspend_lines; lines -= suspend_lines)
+    {
+      co_await yield_t(prefetcher, next, suspend_lines);
+      next += suspend_lines * pf_line_size;
+    }
+    co_await yield_t(prefetcher, next, lines);
+    for (size_t r = 0; r < rows; r += block_size)
+    {
+      size_t block_rows = std::min<size_t>(block_size, rows - r);
+      rt_data.infer_rows(w, x, block_rows, result_ptr);
+      x += row_len * block_rows;
+      result_ptr += block_rows;
+    }
+  }
+}
 
-////////////////////////////////////////////////////////////////
-// Weights
-////////////////////////////////////////////////////////////////
+// Per-sensor work areas of the kernel SVM paths: |x|^2 and the running
+// total of each sample. Each sensor in flight holds one, taken from a
+// free list per thread, so after the first sensors none is allocated.
+class kernel_scratch
+{
+public:
+  explicit kernel_scratch(size_t sample_count) : sample_count_(sample_count)
+  {
+    std::vector<std::vector<int64_t> >& free = free_list();
+    if (!free.empty())
+    {
+      buffer_ = std::move(free.back());
+      free.pop_back();
+    }
+    buffer_.resize(2 * sample_count);
+    std::fill(buffer_.begin() + sample_count, buffer_.end(), 0);
+  }
+  kernel_scratch(const kernel_scratch&) = delete;
+  kernel_scratch& operator=(const kernel_scratch&) = delete;
+  ~kernel_scratch()
+  {
+    free_list().push_back(std::move(buffer_));
+  }
+  int64_t* x_norms() { return buffer_.data(); }
+  int64_t* totals() { return buffer_.data() + sample_count_; }
+private:
+  static std::vector<std::vector<int64_t> >& free_list()
+  {
+    thread_local std::vector<std::vector<int64_t> > free;
+    return free;
+  }
+  size_t sample_count_;
+  std::vector<int64_t> buffer_;
+};
 
-/*
-The ID in columns 0-1 is passed to a lookup function which
-executes some pointer chasing to retrieve the address of
-the weights for the specific sensor.
+// Kernel SVMs: every support vector is scored against all samples of 
+// the sensor, so the sample rows are fetched once and each support 
+// vector gets its own prefetch and suspension point.
+template <typename PREFETCHER_T, typename TASK_T = resumable>
+static TASK_T infer_sensor_kernel_coro(const PREFETCHER_T &prefetcher, runtime_data &rt_data,
+                                       size_t coroutine_index)
+{
+  typedef typename coro_task_traits<TASK_T, PREFETCHER_T>::yield_type yield_t;
+  bpt_data_t sensor_index = (bpt_data_t)coroutine_index;
+  co_await yield_t(prefetcher);
 
-This will be a prime beneficiary of prefetching.
-*/
+  const data_item_t *x, *w;
 
-void create_sensor_ids(const run_time_settings_t &rt, std::vector<bpt_key_t> &sensor_ids)
-{
-  sensor_ids.clear();
-  for (uint32_t i = 0; i < rt.sensor_count; i++)
+  // Get sensor data base
+  const data_vector_t& x_vec = rt_data.resolve_x_vec(sensor_index);
+  x = x_vec.data();
+  auto row_len = rt_data.rt.sv_len;
+  auto sample_count = x_vec.size() / row_len;
+  x_next = prefetcher.prefetch(reinterpret_cast<const char*>(x), 
+    to_pf_line_count(x_vec.size() * sizeof(data_item_t)));
+
+  // Get result base
+  size_t results_size = sample_count * sizeof(result_t);
+  size_t results_line_count = to_pf_line_count(results_size);
+  result_vector_t& results = rt_data.resolve_results_vec(sensor_index);
+  result_t* result_ptr = results.data();
+  result_next = prefetcher.prefetchw(reinterpret_cast<char*>(result_ptr), results_line_count);
+  co_await yield_t(prefetcher);
+
+  const svm_kernel_evaluator<data_item_t>& eval = rt_data.kernel_eval;
+  kernel_scratch scratch(sample_count);
+  int64_t* x_norms = scratch.x_norms();
+  int64_t* totals = scratch.totals();
+  for (size_t sample = 0; sample < sample_count; sample++)
   {
-    bpt_key_t key;
-    uuid::generate_uuid_v4_num(key.uid);
-    sensor_ids.push_back(key);
+    x_norms[sample] = eval.norm(x + (sample * row_len), row_len);
+  }
+
+  // Resolve support vectors for this sensor
+  w = rt_data.resolve_w(sensor_index);
+  const int64_t* sv_norms = rt_data.resolve_sv_norms(sensor_index);
+  size_t sv_line_count = to_pf_line_count(rt_data.rt.w_len * sizeof(data_item_t));
+  for (uint32_t j = 0; j < rt_data.rt.sv_count; j++, w += rt_data.rt.w_len)
+  {
+    co_await yield_t(prefetcher, w, sv_line_count);
+    svm_kernel_accumulate(eval, w[0], w + 1, sv_norms[j], 
+      x, x_norms, sample_count, row_len, row_len, totals);
+  }
+
+  data_item_t bias = rt_data.kernel_biases[sensor_index];
+  for (size_t sample = 0; sample < sample_count; sample++)
+  {
+    result_ptr[sample] = eval.decide(totals[sample], bias) ? 1 : 0;
   }
 }
 
-void create_sensor_btree(const run_time_settings_t &rt, std::vector<bpt_key_t> &sensor_ids,
-  bpt_map_t& map)
+#ifndef USE_GENERIC_COROUTINE_RUNNER
+void run_infer_coroutine(runtime_data &rt_data)
 {
-  map.clear();
-  // i is the data -> row number in weights array
-  for (uint32_t i = 0; i < rt.sensor_count; i++) 
+  prefetch_true prefetcher;
+
+  std::vector<resumable> tasks;
+  std::vector<bool> done(rt_data.rt.task_count, false);
+  size_t incomplete = rt_data.rt.sensor_count;
+
+  for (size_t b = 0; b < (size_t)rt_data.rt.task_count; b++)
   {
-    map[sensor_ids[i]] = i;
+    tasks.push_back(infer_sensor_coro(prefetcher, rt_data, b));
+  }
+
+  size_t next = (size_t)rt_data.rt.task_count;
+  while (incomplete > 0)
+  {
+    for (size_t c = 0; c < tasks.size(); c++)
+    {
+      if (done[c])
+      {
+        continue;
+      }
+      resumable &t = tasks[c];
+      if (t.is_complete())
+      {
+        if (next < rt_data.rt.sensor_count)
+        {
+          tasks[c] = infer_sensor_coro(prefetcher, rt_data, next);
+          next++;
+        }
+        else
+        {
+          done[c] = true;
+        }
+        incomplete--;
+      }
+      else
+      {
+        t.resume();
+      }
+    }
   }
 }
+#endif
 
-// The weights are stored in a big array (like a file), and the tree contains
-// an offset in the leaf node.
-// This seems more realistic. It also creates one more "pointer" to chase.
+#ifdef USE_GENERIC_COROUTINE_RUNNER
+////////////////////////////////////////////////////////////////
+// Batched ingest
+////////////////////////////////////////////////////////////////
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wunused-parameter"
-void populate_weights_simulated(const run_time_settings_t &rt, const std::vector<bpt_key_t> &sensor_ids, std::vector<data_item_t> &weights)
+// A batch of received datagrams, and the sensor each one resolved to
+struct ingest_batch_t
 {
-  std::mt19937 engine; // Mersenne twister MT19937
-  bounded_distribution<data_item_t> distribution(rt.weights_bounds);
-  engine.seed(5432);
+  runtime_data &rt_data;
+  const std::vector<data_item_t>* buffers;
+  std::vector<uint32_t> sensor_indices;
+};
 
-  auto rand_weights = [&]() { return distribution(engine); };
-  weights.resize((rt.sv_len + 1) * rt.sensor_count);
-  std::generate(weights.begin(), weights.end(), rand_weights);
-  if (rt.verbosity >= 3)
+// Finds the sensor of one datagram a tree node per step, prefetching
+// the next node before each suspension, then prefetches the 
+// destination row for writing. batch_ingester checks the header and
+// copies the data, in arrival order, once the whole batch has run.
+template <typename PREFETCHER_T>
+static resumable ingest_datagram_coro(const PREFETCHER_T &prefetcher, ingest_batch_t &batch,
+                                      size_t coroutine_index)
+{
+  typedef prefetch_suspend<PREFETCHER_T> yield_t;
+  runtime_data &rt_data = batch.rt_data;
+  const bpt_map_t& map = rt_data.weights_map;
+  const datagram_t *row_ptr = reinterpret_cast<const datagram_t*>(batch.buffers[coroutine_index].data());
+  batch.sensor_indices[coroutine_index] = (uint32_t)-1;
+
+  const btree_accessor::node_t* n = btree_accessor::root(map);
+  if (!n)
   {
-    dump_fp_vector(weights, std::cout, "weights");
+    co_return;
+  }
+  // Nodes are never shared between levels, so the child's level tells 
+  // its size before it is read
+  for (unsigned short level = n->level; level > 0; level--)
+  {
+    n = btree_accessor::child(map, n, row_ptr->sensor_id);
+    prefetch_range(prefetcher, n, btree_accessor::node_bytes(level - 1));
+    co_await yield_t(prefetcher);
+  }
+  bpt_data_t sensor_index;
+  if (!btree_accessor::leaf_find(map, n, row_ptr->sensor_id, sensor_index))
+  {
+    co_return;
+  }
+  batch.sensor_indices[coroutine_index] = sensor_index;
+  if (sensor_index >= rt_data.rt.sensor_count || row_ptr->seq_id >= rt_data.rt.sample_count)
+  {
+    co_return;
   }
-}
 
-void populate_weights_stored(const run_time_settings_t &rt, const std::vector<bpt_key_t> &sensor_ids, std::vector<data_item_t> &weights)
-{
-  // TODO
+  // The row's vector, then the row
+  prefetch_range(prefetcher, &rt_data.sensor_data[sensor_index], sizeof(data_vector_t));
+  co_await yield_t(prefetcher);
+  data_item_t* row = rt_data.sensor_data[sensor_index].data() + (row_ptr->seq_id * rt_data.rt.sv_len);
+  prefetchw_range(prefetcher, row, rt_data.rt.sv_len * sizeof(data_item_t));
 }
-#pragma GCC diagnostic pop
 
-void populate_weights(const run_time_settings_t &rt, const std::vector<bpt_key_t> &sensor_ids, std::vector<data_item_t> &weights)
+// Saves datagrams a batch at a time: one coroutine per datagram
+class batch_ingester
 {
-  if (rt.simulate_weights)
+public:
+  explicit batch_ingester(runtime_data &rt_data)
+  : batch_ { rt_data, nullptr, {} }, runner_(prefetcher_, batch_)
   {
-    populate_weights_simulated(rt, sensor_ids, weights);
   }
-  else
+
+  // As runtime_data::save_input_data() for each of count buffers, in
+  // order; returns how many were rejected, and accepted() tells which
+  size_t save(const std::vector<data_item_t>* buffers, size_t count)
   {
-    populate_weights_stored(rt, sensor_ids, weights);
+    batch_.buffers = buffers;
+    batch_.sensor_indices.resize(count);
+    runner_.run(count, count, ingest_datagram_coro<prefetch_true>);
+    runtime_data &rt_data = batch_.rt_data;
+    accepted_.resize(count);
+    size_t rejected = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+      const datagram_t *row_ptr = reinterpret_cast<const datagram_t*>(buffers[i].data());
+      data_item_t* row = rt_data.input_row(batch_.sensor_indices[i], *row_ptr);
+      if (row)
+      {
+        std::copy(row_ptr->data, row_ptr->data + rt_data.rt.sv_len, row);
+      }
+      accepted_[i] = (row != nullptr);
+      rejected += row ? 0 : 1;
+    }
+    return rejected;
   }
-}
+  // Whether buffer i of the last save() was saved
+  bool accepted(size_t i) const { return accepted_[i] != 0; }
 
-////////////////////////////////////////////////////////////////
-// Runtime data
-////////////////////////////////////////////////////////////////
+private:
+  prefetch_true prefetcher_;
+  ingest_batch_t batch_;
+  coroutine_ring_runner<prefetch_true, ingest_batch_t> runner_;
+  std::vector<uint8_t> accepted_;
+};
 
-class runtime_data
+// Zero-copy ingest: gives receivers each datagram's row of sensor_data
+class row_placer : public input_placer
 {
 public:
-  runtime_data(const run_time_settings_t &rt_)
-      : rt(rt_)
+  row_placer(runtime_data &rt_data, NanoTimer &timer) : rt_data_(rt_data), timer_(timer) {}
+  virtual data_item_t* place(const datagram_t& header)
   {
-    #if MEASURE_LOCALITY==1
-    locality_filestream.open("locality.csv", 
-          std::ofstream::out | std::ofstream::app);
-    #endif
+    placed_at_ = timer_.get_timestamp();
+    return rt_data_.input_row(header);
   }
+  virtual size_t row_length() const { return rt_data_.rt.sv_len; }
+  // When the last header came in: saving runs from then, without the wait for input
+  NanoTimer::timeres_t placed_at() const { return placed_at_; }
+private:
+  runtime_data &rt_data_;
+  NanoTimer &timer_;
+  NanoTimer::timeres_t placed_at_ = 0;
+};
 
-  // Fixed input data
-  const run_time_settings_t &rt;
-  std::vector<bpt_key_t> source_sensor_ids;
-  bpt_map_t weights_map;
-
-  // Weights - calculated once only
-  std::vector<data_item_t> weights;
-
-  // Dynamic data
-  std::vector<data_vector_t> sensor_data;
-  std::vector<id_t> seq_ids;
-  std::vector<std::vector<result_t> > results;
-
-  // Output
-  std::ofstream report_filestream;
-  std::ofstream perf_filestream;
-  #if MEASURE_LOCALITY==1
-  std::ofstream locality_filestream;
-  #endif
-
-  void initialise()
+// Sensors for a calibration slice: count sensors from first, wrapping
+// at sensor_count, for coroutine_ring_runner::run_source()
+struct sensor_slice_source
+{
+  size_t next_;
+  size_t remaining_;
+  size_t sensor_count_;
+  bool next(size_t& item)
   {
-    // Prepare work areas
-    create_sensor_ids(rt, source_sensor_ids);
-    create_sensor_btree(rt, source_sensor_ids, weights_map);
-
-    // The sequence ID of each sensor tells us how many samples
-    // have been received for that sensor so far
-    seq_ids.resize(rt.sensor_count);
-    std::fill(seq_ids.begin(), seq_ids.end(), 0);
-
-    // The input data for each sensor is held in a continuous 
-    // block of sample_count rows, each of width sv_len
-    sensor_data.resize(rt.sensor_count);
-    for (auto& v: sensor_data) {
-      v.resize(rt.sample_count * rt.sv_len);
+    if (remaining_ == 0)
+    {
+      return false;
     }
+    item = next_;
+    next_ = (next_ + 1 == sensor_count_) ? 0 : next_ + 1;
+    remaining_--;
+    return true;
+  }
+};
 
-    // There is one result for each sample of each sensor
-    results.resize(rt.sensor_count);
-    for (auto& v : results) {
-      v.resize(rt.sample_count);
-      std::fill(v.begin(), v.end(), false);
-    }
+////////////////////////////////////////////////////////////////
+// SVM processing (threads)
+////////////////////////////////////////////////////////////////
 
-    // Populate weights from storage or simulation
-    populate_weights(rt, source_sensor_ids, weights);
-  }
+// Each worker thread runs its own ring of task_count coroutines over
+// the sensors it takes from its range, or steals from another's. The 
+// worker state, frame pool included, sits on lines of its own.
+class thread_infer_runner
+{
+public:
+  typedef coroutine_ring_runner<prefetch_true, runtime_data>::coro_fn_t coro_fn_t;
 
-  inline const data_vector_t& resolve_x_vec(uint32_t sensor_index) const
-  {
-    return sensor_data[sensor_index];
-  }
-  inline const data_item_t *resolve_w(bpt_data_t sensor_index) const
+  thread_infer_runner(runtime_data &rt_data, size_t thread_count, coro_fn_t coro_fn)
+  : rt_data_(rt_data), coro_fn_(coro_fn), pool_(thread_count)
   {
-    return weights.data() + (rt.w_len * sensor_index);
+    for (size_t w = 0; w < thread_count; w++)
+    {
+      workers_.push_back(std::make_unique<worker_t>(prefetcher_, rt_data));
+    }
   }
-  inline std::vector<result_t>& resolve_results_vec(uint32_t sensor_index)
+
+  // Scores every sensor on the first thread_count workers
+  void run(size_t thread_count)
   {
-    return results[sensor_index];
+    thread_count = std::min(thread_count, pool_.size());
+    ranges_.reset(thread_count, rt_data_.rt.sensor_count);
+    pool_.run(thread_count, job_);
+    steals_ += ranges_.steal_count();
+    for (size_t w = 0; w < thread_count; w++)
+    {
+      resumes_ += workers_[w]->runner.resume_count();
+    }
   }
-  inline bool check_sensor_index(bpt_data_t sensor_index) const
+  // Totals over all runs
+  uint64_t steal_count() const { return steals_; }
+  uint64_t resume_count() const { return resumes_; }
+  // Totals over the workers' frame pools
+  size_t frames_created() const
   {
-    if (sensor_index >= rt.sensor_count)
+    size_t created = 0;
+    for (const auto& w : workers_)
     {
-      std::cerr << "Internal error: sensor id " << sensor_index << " is out of range" << std::endl;
-      return false;
+      created += w->frame_pool.created();
     }
-    return true;
+    return created;
   }
-  inline bool update_seq_id(bpt_data_t sensor_index, uint32_t seq_id, bool update)
+  size_t frames_recycled() const
   {
-    uint32_t current_id = seq_ids[sensor_index];
-    if (seq_id != current_id)
+    size_t recycled = 0;
+    for (const auto& w : workers_)
     {
-      std::cerr << "Data error: sensor index " << sensor_index
-                << " got seq_id " << seq_id
-                << "; expected " << current_id << std::endl;
-      return false;
+      recycled += w->frame_pool.recycled();
     }
-    if (update) {
-      seq_ids[sensor_index]++;
-    }
-    return true;
+    return recycled;
   }
-  bool save_input_data(const std::vector<data_item_t>& buffer)
-  {
-    const datagram_t *row_ptr = (const datagram_t *)buffer.data();
-    bool ok = false;
-
-    // Find sensor index from UUID
-    auto itF = weights_map.find(row_ptr->sensor_id);
-    uint32_t sensor_index = itF == weights_map.end() ? (uint32_t)-1 : itF->second;
 
-    // Check data integrity & Match sequence IDs
-    ok = check_sensor_index(sensor_index) 
-      && update_seq_id(sensor_index, row_ptr->seq_id, true);
-    
-    if (ok)
+private:
+  struct alignas(LINE_SIZE) worker_t
+  {
+    worker_t(const prefetch_true& prefetcher, runtime_data &rt_data)
+    : runner(prefetcher, rt_data)
     {
-      // Identify the target block
-      data_vector_t& vec = sensor_data[sensor_index];
-      // Copy the SVM into the correct row of the block
-      std::copy(row_ptr->data, row_ptr->data + rt.sv_len, vec.data() + (row_ptr->seq_id * rt.sv_len));
     }
-    return ok;
-  } 
-  void reset_seq_ids() {
-    std::fill(seq_ids.begin(), seq_ids.end(), 0);
+    // Declared first, so it outlives the frames the runner holds
+    coro_frame_pool frame_pool;
+    coroutine_ring_runner<prefetch_true, runtime_data> runner;
+  };
+
+  void work(size_t worker)
+  {
+    worker_t& w = *workers_[worker];
+    coro_frame_allocator_scope frame_scope(rt_data_.rt.heap_frames ? nullptr : &w.frame_pool);
+    work_steal_source source(ranges_, worker);
+    w.runner.run_source(rt_data_.rt.task_count, source, coro_fn_);
   }
-};
 
+  runtime_data &rt_data_;
+  coro_fn_t coro_fn_;
+  prefetch_true prefetcher_;
+  std::vector<std::unique_ptr<worker_t> > workers_;
+  work_steal_ranges ranges_;
+  worker_pool::job_t job_ = [this](size_t worker) { work(worker); };
+  uint64_t steals_ = 0;
+  uint64_t resumes_ = 0;
+  // Declared last, so the threads stop before anything they use goes
+  worker_pool pool_;
+};
+#endif
 
 ////////////////////////////////////////////////////////////////
-// Performance event monitoring 
+// SVM processing (sequential)
 ////////////////////////////////////////////////////////////////
 
-#include <perf/perf_rec.h>
-#include <perf/pe_summaries.h>
-
-pem_test pem_summaries[EMI_COUNT];
-long long pem_data[PEM_MAX_EVENTS];
-int pem_statistic_count = 0;
-intmax_t pem_duration;
-
-void pem_init(int which_setup)
+void infer_sensor_sequential(runtime_data &rt_data, uint32_t sensor_index)
 {
-  pem_statistic_count = pem_setup(which_setup);
-  ::pe_summaries_init(pem_statistic_count, pem_summaries);
-}
+  const data_item_t *x, *w;
 
-template <typename FP_T>
-void perf_record(size_t which_summary, FP_T fn) {
-  ::perf_record(true, pem_summaries + which_summary, pem_duration, pem_data, fn);
-}
+  // Resolve weights & bias for this sensor
+  w = rt_data.resolve_w(sensor_index);
 
-void perf_report(std::ostream* os, int which_summary)
-{
-  if (os) {
-    const pem_test* p = pem_summaries + which_summary;
-    const char** names = pe_summary_get_names();
-    *os << setw(9) << names[which_summary] << " pe stats : ";
-    for (int i = 0; i < pem_statistic_count; i++) {
-      *os << p->descriptors[i].name << "," << p->extract_value(i) << ",";
-    }
-    *os << std::endl;
-  }
-}
+  // Get sensor data base
+  const data_vector_t& x_vec = rt_data.resolve_x_vec(sensor_index);
+  x = x_vec.data();
+  auto row_len = rt_data.rt.sv_len;
+  auto sample_count = x_vec.size() / row_len;
+  auto block_size = rt_data.rt.block_size;
 
-////////////////////////////////////////////////////////////////
-// Locality
-////////////////////////////////////////////////////////////////
+  // Get result base
+  result_vector_t& results = rt_data.resolve_results_vec(sensor_index);
+  result_t* result_ptr = results.data();
 
-#if MEASURE_LOCALITY==1
-// This code records the addresses of consecutive nodes found in the tree
-// and calculates the locality of the jumps between them
-std::vector<long long> locality_jumps;
-void record_locality(const void* n, const void* nprev)
-{ 
-  const char* pnp = static_cast<const char*>(nprev);
-  const char* pn = static_cast<const char*>(n);
-  locality_jumps.push_back(pn - pnp);
-}
-void clear_locality()
-{
-  locality_jumps.clear();
-}
-void report_locality(runtime_data& rt_data)
-{
-  std::ostream& os = rt_data.locality_filestream;
-  for (size_t i = 0; i < locality_jumps.size(); i++)
+  for (uint32_t sample = 0; sample < sample_count; 
+      sample += block_size, x += row_len * block_size, result_ptr += block_size)
   {
-    if (i > 0) {
-      os << ",";
-    }
-    os << locality_jumps[i];
+    size_t rows = std::min<size_t>(block_size, sample_count - sample);
+    rt_data.infer_rows(w, x, rows, result_ptr);
   }
-  os << std::endl;
 }
-#endif
-
-////////////////////////////////////////////////////////////////
-// SVM processing (coroutine)
-////////////////////////////////////////////////////////////////
 
-const char *x_next, *w_next;
-char* result_next;
-
-template <typename PREFETCHER_T>
-static resumable infer_sensor_coro(const PREFETCHER_T &prefetcher, runtime_data &rt_data,
-                                   size_t coroutine_index)
+void infer_sensor_kernel_sequential(runtime_data &rt_data, uint32_t sensor_index)
 {
-  bpt_data_t sensor_index = (bpt_data_t)coroutine_index;
-  co_await CORO_STD::suspend_always{};
-
   const data_item_t *x, *w;
 
-  size_t weights_size = rt_data.rt.w_len * sizeof(data_item_t);
-  size_t weights_line_count = to_pf_line_count(weights_size);
-
-  // Resolve weights & bias for this sensor
-  w = rt_data.resolve_w(sensor_index);
-  w_next = prefetcher.prefetch(reinterpret_cast<const char*>(w), weights_line_count);
-  co_await CORO_STD::suspend_always{};
-
-  // Inspect w data
-  data_item_t bias = w[0];
-  w++;
-
   // Get sensor data base
   const data_vector_t& x_vec = rt_data.resolve_x_vec(sensor_index);
   x = x_vec.data();
   auto row_len = rt_data.rt.sv_len;
   auto sample_count = x_vec.size() / row_len;
-  size_t data_size = row_len * sizeof(data_item_t);
-  size_t data_line_count = to_pf_line_count(data_size);
 
   // Get result base
-  size_t results_size = sample_count * sizeof(result_t);
-  size_t results_line_count = to_pf_line_count(results_size);
-  std::vector<result_t>& results = rt_data.resolve_results_vec(sensor_index);
+  result_vector_t& results = rt_data.resolve_results_vec(sensor_index);
   result_t* result_ptr = results.data();
-  result_next = prefetcher.prefetchw(reinterpret_cast<char*>(result_ptr), results_line_count);
-  // TODO? do the output prefetch on a per-item basis inside the loop?
 
-  for (uint32_t sample = 0; sample < sample_count; sample++, x += row_len, result_ptr++)
+  const svm_kernel_evaluator<data_item_t>& eval = rt_data.kernel_eval;
+  kernel_scratch scratch(sample_count);
+  int64_t* x_norms = scratch.x_norms();
+  int64_t* totals = scratch.totals();
+  for (size_t sample = 0; sample < sample_count; sample++)
+  {
+    x_norms[sample] = eval.norm(x + (sample * row_len), row_len);
+  }
+
+  // Resolve support vectors for this sensor
+  w = rt_data.resolve_w(sensor_index);
+  const int64_t* sv_norms = rt_data.resolve_sv_norms(sensor_index);
+  for (uint32_t j = 0; j < rt_data.rt.sv_count; j++, w += rt_data.rt.w_len)
+  {
+    svm_kernel_accumulate(eval, w[0], w + 1, sv_norms[j], 
+      x, x_norms, sample_count, row_len, row_len, totals);
+  }
+
+  data_item_t bias = rt_data.kernel_biases[sensor_index];
+  for (size_t sample = 0; sample < sample_count; sample++)
+  {
+    result_ptr[sample] = eval.decide(totals[sample], bias) ? 1 : 0;
+  }
+}
+
+void run_infer_sequential(runtime_data &rt_data)
+{
+  if (rt_data.rt.kernel_type != SVM_KERNEL_LINEAR)
+  {
+    for (uint32_t i = 0; i < rt_data.rt.sensor_count; i++)
+    {
+      infer_sensor_kernel_sequential(rt_data, i);
+    }
+    return;
+  }
+  for (uint32_t i = 0; i < rt_data.rt.sensor_count; i++)
   {
-    x_next = prefetcher.prefetch(reinterpret_cast<const char*>(x), data_line_count);
-    co_await CORO_STD::suspend_always{};
-    *result_ptr = svm_infer(w, x, bias, row_len) ? 1 : 0;
+    infer_sensor_sequential(rt_data, i);
   }
 }
 
-#ifndef USE_GENERIC_COROUTINE_RUNNER
-void run_infer_coroutine(runtime_data &rt_data)
+////////////////////////////////////////////////////////////////
+// SVM processing (software pipelined)
+////////////////////////////////////////////////////////////////
+
+// The sequential loop with prefetches issued d = prefetch_distance 
+// ahead: while sensor i is scored, the weights and results of sensor
+// i + d are fetched, and while a block of rows is scored, the block d
+// blocks on in scoring order, which may belong to a later sensor
+void run_infer_pipelined(runtime_data &rt_data)
 {
   prefetch_true prefetcher;
+  const run_time_settings_t& rt = rt_data.rt;
+  size_t distance = rt.prefetch_distance;
+  size_t sensor_count = rt.sensor_count;
+  size_t row_len = rt.sv_len;
+  size_t block_size = rt.block_size;
+  size_t sensor_blocks = (rt.sample_count + block_size - 1) / block_size;
+  size_t block_count = sensor_blocks * sensor_count;
+  size_t results_line_count = to_pf_line_count(rt.sample_count * sizeof(result_t));
+
+  auto prefetch_sensor = [&](size_t sensor_index)
+  {
+    if (sensor_index < sensor_count)
+    {
+      w_next = prefetch_weights(prefetcher, rt_data, (bpt_data_t)sensor_index);
+      result_next = prefetcher.prefetchw(
+        reinterpret_cast<char*>(rt_data.resolve_results_vec(sensor_index).data()), results_line_count);
+    }
+  };
+  auto prefetch_block = [&](size_t block)
+  {
+    if (block < block_count)
+    {
+      size_t first_sample = (block % sensor_blocks) * block_size;
+      size_t rows = std::min<size_t>(block_size, rt.sample_count - first_sample);
+      const data_item_t* x = rt_data.resolve_x_vec(block / sensor_blocks).data() + (first_sample * row_len);
+      x_next = prefetcher.prefetch(reinterpret_cast<const char*>(x), 
+        to_pf_line_count(rows * row_len * sizeof(data_item_t)));
+    }
+  };
 
-  std::vector<resumable> tasks;
-  std::vector<bool> done(rt_data.rt.task_count, false);
-  size_t incomplete = rt_data.rt.sensor_count;
-
-  for (size_t b = 0; b < (size_t)rt_data.rt.task_count; b++)
+  // Prologue: what the first d steps will read
+  for (size_t i = 0; i < distance; i++)
   {
-    tasks.push_back(infer_sensor_coro(prefetcher, rt_data, b));
+    prefetch_sensor(i);
+    prefetch_block(i);
   }
 
-  size_t next = (size_t)rt_data.rt.task_count;
-  while (incomplete > 0)
+  size_t block = 0;
+  for (size_t i = 0; i < sensor_count; i++)
   {
-    for (size_t c = 0; c < tasks.size(); c++)
+    if (distance)
     {
-      if (done[c])
-      {
-        continue;
-      }
-      resumable &t = tasks[c];
-      if (t.is_complete())
-      {
-        if (next < rt_data.rt.sensor_count)
-        {
-          tasks[c] = infer_sensor_coro(prefetcher, rt_data, next);
-          next++;
-        }
-        else
-        {
-          done[c] = true;
-        }
-        incomplete--;
-      }
-      else
+      prefetch_sensor(i + distance);
+    }
+    const data_item_t* w = rt_data.resolve_w(i);
+    const data_item_t* x = rt_data.resolve_x_vec(i).data();
+    result_t* result_ptr = rt_data.resolve_results_vec(i).data();
+    for (uint32_t sample = 0; sample < rt.sample_count; 
+        sample += block_size, x += row_len * block_size, result_ptr += block_size, block++)
+    {
+      if (distance)
       {
-        t.resume();
+        prefetch_block(block + distance);
       }
+      size_t rows = std::min<size_t>(block_size, rt.sample_count - sample);
+      rt_data.infer_rows(w, x, rows, result_ptr);
     }
   }
 }
-#endif
 
 ////////////////////////////////////////////////////////////////
-// SVM processing (sequential)
+// SVM processing (AMAC)
 ////////////////////////////////////////////////////////////////
 
-void infer_sensor_sequential(runtime_data &rt_data, uint32_t sensor_index)
+// Asynchronous memory access chaining: infer_sensor_coro written out
+// as a state machine. Each sensor in flight has an explicit state, 
+// and a circular buffer of task_count states is advanced one stage at
+// a time, with the same prefetches as the coroutine at the same 
+// points: rows in groups of prefetch_group_rows(), at most 
+// suspend_lines lines per step. The difference from the coroutine 
+// model is the cost of frames and resumption.
+#define AMAC_STAGE_WEIGHTS 0 // Prefetch the weights
+#define AMAC_STAGE_ROWS 1 // Prefetch the results and the first rows
+#define AMAC_STAGE_FETCH 2 // Prefetch the next chunk of a group of rows
+#define AMAC_STAGE_INFER 3 // Score a group of rows, prefetch the next
+
+struct amac_state_t
 {
-  const data_item_t *x, *w;
+  int stage;
+  bpt_data_t sensor_index;
+  const data_item_t* w;
+  const data_item_t* x;
+  result_t* result_ptr;
+  uint32_t sample;
+  uint32_t sample_count;
+  const svm_band_t* bands; // Sparse sensors only
+  size_t band_count;
+  uint32_t group_rows; // Rows being prefetched or scored
+  const char* fetch_next; // The group's lines still to prefetch
+  size_t fetch_lines;
+};
 
-  // Resolve weights & bias for this sensor
-  w = rt_data.resolve_w(sensor_index);
+// Prefetches the next chunk of the group, and scores it once all are issued
+template <typename PREFETCHER_T>
+static void amac_fetch(const PREFETCHER_T &prefetcher, const run_time_settings_t& rt, amac_state_t& st)
+{
+  size_t lines = std::min<size_t>(st.fetch_lines, rt.suspend_lines);
+  x_next = prefetcher.prefetch(st.fetch_next, lines);
+  st.fetch_next += lines * pf_line_size;
+  st.fetch_lines -= lines;
+  st.stage = (st.fetch_lines > 0) ? AMAC_STAGE_FETCH : AMAC_STAGE_INFER;
+}
+
+// Advances one sensor by one stage; returns false once it is done
+template <typename PREFETCHER_T>
+static bool amac_step(const PREFETCHER_T &prefetcher, runtime_data &rt_data, amac_state_t& st)
+{
+  const run_time_settings_t& rt = rt_data.rt;
+  size_t data_size = rt.sv_len * sizeof(data_item_t);
+  switch (st.stage)
+  {
+  case AMAC_STAGE_WEIGHTS:
+    st.w = rt_data.resolve_w(st.sensor_index);
+    w_next = prefetch_weights(prefetcher, rt_data, st.sensor_index);
+    st.stage = AMAC_STAGE_ROWS;
+    return true;
 
-  // Inspect w data
-  data_item_t bias = w[0];
-  w++;
+  case AMAC_STAGE_ROWS:
+  {
+    const data_vector_t& x_vec = rt_data.resolve_x_vec(st.sensor_index);
+    st.x = x_vec.data();
+    st.sample_count = x_vec.size() / rt.sv_len;
+    st.result_ptr = rt_data.resolve_results_vec(st.sensor_index).data();
+    result_next = prefetcher.prefetchw(reinterpret_cast<char*>(st.result_ptr), 
+      to_pf_line_count(st.sample_count * sizeof(result_t)));
+    st.bands = rt_data.is_sparse(st.sensor_index) 
+      ? rt_data.resolve_bands(st.sensor_index, st.band_count) : nullptr;
+    st.sample = 0;
+    break; // To the prefetch of the first group
+  }
 
-  // Get sensor data base
-  const data_vector_t& x_vec = rt_data.resolve_x_vec(sensor_index);
-  x = x_vec.data();
-  auto row_len = rt_data.rt.sv_len;
-  auto sample_count = x_vec.size() / row_len;
+  case AMAC_STAGE_FETCH:
+    amac_fetch(prefetcher, rt, st);
+    return true;
 
-  // Get result base
-  std::vector<result_t>& results = rt_data.resolve_results_vec(sensor_index);
-  result_t* result_ptr = results.data();
+  case AMAC_STAGE_INFER:
+    for (size_t r = 0; r < st.group_rows; r += rt.block_size)
+    {
+      size_t block_rows = std::min<size_t>(rt.block_size, st.group_rows - r);
+      rt_data.infer_rows(st.w, st.x, block_rows, st.result_ptr);
+      st.x += rt.sv_len * block_rows;
+      st.result_ptr += block_rows;
+    }
+    st.sample += st.group_rows;
+    break;
+  }
 
-  for (uint32_t sample = 0; sample < sample_count; sample++, x += row_len, result_ptr++)
+  // Prefetch the next group of rows, if any; sparse sensors' groups are
+  // one block, of their bands' lines only
+  if (st.sample >= st.sample_count)
+  {
+    return false;
+  }
+  if (st.bands)
   {
-    *result_ptr = svm_infer(w, x, bias, row_len) ? 1 : 0;
+    st.group_rows = std::min<uint32_t>(rt.block_size, st.sample_count - st.sample);
+    for (size_t r = 0; r < st.group_rows; r++)
+    {
+      x_next = prefetch_bands(prefetcher, st.x + (r * rt.sv_len), st.bands, st.band_count);
+    }
+    st.stage = AMAC_STAGE_INFER;
+    return true;
   }
+  st.group_rows = (uint32_t)std::min<size_t>(prefetch_group_rows(rt), st.sample_count - st.sample);
+  st.fetch_next = reinterpret_cast<const char*>(st.x);
+  st.fetch_lines = to_pf_line_count(data_size * st.group_rows);
+  amac_fetch(prefetcher, rt, st);
+  return true;
 }
 
-void run_infer_sequential(runtime_data &rt_data)
+// Returns the number of steps taken
+uint64_t run_infer_amac(runtime_data &rt_data)
 {
-  for (uint32_t i = 0; i < rt_data.rt.sensor_count; i++)
+  prefetch_true prefetcher;
+  size_t sensor_count = rt_data.rt.sensor_count;
+  size_t live = std::min<size_t>(rt_data.rt.task_count, sensor_count);
+  std::vector<amac_state_t> states(live);
+  auto start = [](amac_state_t& st, size_t sensor_index)
   {
-    infer_sensor_sequential(rt_data, i);
+    st = amac_state_t { AMAC_STAGE_WEIGHTS, (bpt_data_t)sensor_index, nullptr, nullptr, nullptr, 0, 0, nullptr, 0, 0, nullptr, 0 };
+  };
+  for (size_t b = 0; b < live; b++)
+  {
+    start(states[b], b);
+  }
+
+  // As coroutine_ring_runner: a finished state takes the next sensor,
+  // or, when there are none left, the last state takes its place
+  uint64_t steps = 0;
+  size_t next_sensor = live;
+  size_t head = 0;
+  while (live > 0)
+  {
+    steps++;
+    if (!amac_step(prefetcher, rt_data, states[head]))
+    {
+      if (next_sensor == sensor_count)
+      {
+        states[head] = states[--live];
+        if (head == live)
+        {
+          head = 0;
+        }
+        continue;
+      }
+      start(states[head], next_sensor++);
+    }
+    head = (head + 1 == live) ? 0 : head + 1;
   }
+  return steps;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -993,6 +3364,11 @@ void run_infer_sequential(runtime_data &rt_data)
 const char *model_names[] = {
     "sequential",
     "coroutine ",
+    "symmetric ",
+    "threads   ",
+    "amac      ",
+    "pipelined ",
+    "deadline  ",
     0};
 
 std::ostream &get_output_stream(runtime_data &rt_data)
@@ -1018,7 +3394,17 @@ void report_header(runtime_data &rt_data)
 {
   if (rt_data.rt.exec_pattern == EXEC_PATTERN_BOTH)
   {
-    get_output_stream(rt_data) << "sensors,samples,datagram,seq0,coro,seq1,ratio0,ratio1" << std::endl;
+    std::ostream& os = get_output_stream(rt_data);
+    os << "sensors,samples,datagram,seq0,coro,seq1,ratio0,ratio1";
+    if (rt_data.rt.compare_model == EXEC_MODEL_THREADS)
+    {
+      // The scaling curve: the threads model on 1 to thread_count threads
+      for (uint16_t t = 1; t <= rt_data.rt.thread_count; t++)
+      {
+        os << sep << "threads_" << t;
+      }
+    }
+    os << std::endl;
   }
   else
   {
@@ -1037,20 +3423,26 @@ void report_one(runtime_data &rt_data, int exec_model, NanoTimer::timeres_t proc
 }
 
 void report_three(runtime_data &rt_data, const NanoTimer::timeres_t* spans, 
-  size_t span_count, const float* ratios)
+  size_t span_count, const float* ratios, 
+  const std::vector<NanoTimer::timeres_t>& scaling_spans)
 {
   if (span_count != 3) {
     return;
   }
-  get_output_stream(rt_data)
-      << rt_data.rt.sensor_count << sep
+  std::ostream& os = get_output_stream(rt_data);
+  os  << rt_data.rt.sensor_count << sep
       << rt_data.rt.sample_count << sep
       << rt_data.rt.datagram_size << sep
       << spans[0] << sep
       << spans[1] << sep
       << spans[2] << sep
       << ratios[0] << sep
-      << ratios[1] << std::endl;
+      << ratios[1];
+  for (auto span : scaling_spans)
+  {
+    os << sep << span;
+  }
+  os << std::endl;
 }
 
 void report_tree(const bpt_map_t& weights_map, std::ostream& os)
@@ -1095,7 +3487,49 @@ void perf_header(runtime_data &rt_data)
   if (rt_data.rt.perf_file.empty()) {
     return;
   }
-  get_perf_stream(rt_data) << "repeat,step,model,cpu_cycles,instructions,d_cache_reads,d_cache_misses" << std::endl;
+  std::ostream& os = get_perf_stream(rt_data);
+  if (rt_data.rt.autotune)
+  {
+    // The tuning trace shares the file; its lines start with a tag
+    os << "# tune,repeat,round,tasks,prefetch,metric,cost_per_sensor" << std::endl;
+    os << "# tuned,repeat,reason,tasks,prefetch,mean_cost_per_sensor" << std::endl;
+  }
+  if (rt_data.rt.compare_model == EXEC_MODEL_DEADLINE)
+  {
+    os << "# deadline,repeat,class,sensors,misses,mean_latency_ns,max_latency_ns" << std::endl;
+  }
+  os << "repeat,step,model,cpu_cycles,instructions,d_cache_reads,d_cache_misses" << std::endl;
+}
+
+void autotune_trace_line(runtime_data &rt_data, uint32_t iRepeat, size_t round, 
+  const autotune_candidate_t& candidate, bool cycles, double cost)
+{
+  if (rt_data.rt.perf_file.empty()) {
+    return;
+  }
+  get_perf_stream(rt_data) << "tune" << sep << iRepeat << sep << round << sep 
+    << candidate.task_count << sep << candidate.prefetch << sep
+    << (cycles ? "cycles" : "ns") << sep << cost << std::endl;
+}
+
+void autotune_chosen_line(runtime_data &rt_data, uint32_t iRepeat, int reason, 
+  const autotune_candidate_t& chosen)
+{
+  if (rt_data.rt.perf_file.empty()) {
+    return;
+  }
+  get_perf_stream(rt_data) << "tuned" << sep << iRepeat << sep << autotune_reason_name(reason) << sep 
+    << chosen.task_count << sep << chosen.prefetch << sep << chosen.mean_cost() << std::endl;
+}
+
+void deadline_line(runtime_data &rt_data, uint32_t iRepeat, int priority_class, 
+  const deadline_stats_t& stats)
+{
+  if (rt_data.rt.perf_file.empty()) {
+    return;
+  }
+  get_perf_stream(rt_data) << "deadline" << sep << iRepeat << sep << priority_class_name(priority_class) << sep
+    << stats.count << sep << stats.misses << sep << stats.mean_latency() << sep << stats.latency_max << std::endl;
 }
 
 void perf_line(runtime_data &rt_data, uint32_t iRepeat, int iModel, int exec_model)
@@ -1130,10 +3564,16 @@ void sys_wait_us(unsigned long wait_us)
  * @param argv The command line arguments
  * @return int 0 for successful execution, non-zero for error
  */
+#ifndef INFER7_NO_MAIN
 int main(int argc, char **argv)
 {
   struct run_time_settings_t rt;
 
+  // Prefetch stride, cache flush and the default sizes follow the caches
+  rt.topology = discover_cache_topology();
+  pf_line_size = rt.topology.line_size;
+  clear_cache_bytes = 4 * rt.topology.llc;
+
   if (!parse_cmd_line(argc, argv, rt))
   {
     // cmd line error or just show usage
@@ -1185,18 +3625,77 @@ int main(int argc, char **argv)
 
   // Prepare to receive input
   std::unique_ptr<input_receiver> receiver;
+  udp_receiver* network = nullptr;
   if (rt.simulate_amplitudes) 
   {
     receiver = std::make_unique<input_simulator>(
       rt_data.source_sensor_ids, 
       rt.sample_count, 
       rt.datagram_size, 
-      rt.amplitude_bounds);
+      rt.amplitude_bounds,
+      rt.early_exit ? &rt_data.bin_order : nullptr);
+  }
+  else if (rt.port != 0)
+  {
+    try
+    {
+      auto udp = std::make_unique<udp_receiver>(
+        open_datagram_socket(rt.recv_backend, rt.port, rt.datagram_size, rt.recv_batch, rt.verbosity),
+        rt.datagram_size, (uint64_t)rt.sensor_count * rt.sample_count);
+      network = udp.get();
+      if (rt.verbosity > 0)
+      {
+        std::cerr << "Receiving on UDP port " << network->port() << " with " << network->backend_name() << "\r\n";
+      }
+      receiver = std::move(udp);
+    }
+    catch (const std::exception &ex)
+    {
+      std::cerr << "UDP port " << rt.port << ": " << ex.what() << "\r\n";
+      return 1;
+    }
   }
   else
   {
-    std::cerr << "Only simulated input is supported at this time\r\n";
-    return 1;
+    try
+    {
+      auto replay = std::make_unique<capture_receiver>(rt.data_source);
+      std::string mismatch = rt_data.capture_mismatch(replay->file());
+      if (!mismatch.empty())
+      {
+        std::cerr << "Capture " << rt.data_source << ": " << mismatch << "\r\n";
+        return 1;
+      }
+      receiver = std::move(replay);
+    }
+    catch (const std::exception &ex)
+    {
+      std::cerr << ex.what() << "\r\n";
+      return 1;
+    }
+  }
+  if (!rt.record_file.empty())
+  {
+    static_assert(sizeof(bpt_key_t) == CAPTURE_ID_BYTES, "capture IDs are sensor UUIDs");
+    try
+    {
+      auto writer = std::make_unique<capture_writer>(rt.record_file, rt_data.source_sensor_ids.data(), 
+        rt.sensor_count, rt.sample_count, rt.datagram_size);
+      receiver = std::make_unique<recording_receiver>(std::move(receiver), std::move(writer));
+    }
+    catch (const std::exception &ex)
+    {
+      std::cerr << ex.what() << "\r\n";
+      return 1;
+    }
+  }
+  paced_receiver* pacer = nullptr;
+  latency_recorder latencies;
+  if (rt.rate > 0.0)
+  {
+    auto paced = std::make_unique<paced_receiver>(std::move(receiver), rt.rate, rt.arrivals);
+    pacer = paced.get();
+    receiver = std::move(paced);
   }
 
   // Performance data
@@ -1210,10 +3709,216 @@ int main(int argc, char **argv)
   }
   perf_header(rt_data); // Ignored if perf_file.empty()
 
+  // Coroutine frames are recycled through a pool unless heap_frames;
+  // the pool must outlive the runners, which own the last frames
+  coro_frame_pool frame_pool;
+  coro_frame_allocator_scope frame_scope(rt.heap_frames ? nullptr : &frame_pool);
+
   #ifdef USE_GENERIC_COROUTINE_RUNNER
   prefetch_true prefetcher;
   coroutine_runner<prefetch_true, runtime_data, std::resumable> runner_with_prefetch(prefetcher, rt_data);
+  coroutine_ring_runner<prefetch_true, runtime_data, std::resumable> ring_runner_with_prefetch(prefetcher, rt_data);
+  auto infer_coro = (rt.kernel_type == SVM_KERNEL_LINEAR) 
+    ? infer_sensor_coro<prefetch_true> : infer_sensor_kernel_coro<prefetch_true>;
+  // Without prefetch, for the auto-tuner
+  prefetch_false no_prefetcher;
+  coroutine_runner<prefetch_false, runtime_data, std::resumable> runner_without_prefetch(no_prefetcher, rt_data);
+  coroutine_ring_runner<prefetch_false, runtime_data, std::resumable> ring_runner_without_prefetch(no_prefetcher, rt_data);
+  auto infer_coro_without_prefetch = (rt.kernel_type == SVM_KERNEL_LINEAR) 
+    ? infer_sensor_coro<prefetch_false> : infer_sensor_kernel_coro<prefetch_false>;
+  // Interleave depth and prefetch policy of the coroutine model, 
+  // chosen by the auto-tuner if rt.autotune
+  size_t coro_tasks = rt.task_count;
+  bool coro_prefetch = true;
+  // Resumptions, for the scheduling cost per suspension point
+  uint64_t coro_resumes = 0;
+  auto run_coro_with = [&](auto& ring_runner, auto& poll_runner, auto coro_fn)
+  {
+    if (rt.runner == RUNNER_RING)
+    {
+      ring_runner.run(coro_tasks, rt_data.rt.sensor_count, coro_fn);
+      coro_resumes += ring_runner.resume_count();
+    }
+    else
+    {
+      poll_runner.run(coro_tasks, rt_data.rt.sensor_count, coro_fn);
+      coro_resumes += poll_runner.resume_count();
+    }
+  };
+  auto run_infer_coro = [&]()
+  {
+    if (coro_prefetch)
+    {
+      run_coro_with(ring_runner_with_prefetch, runner_with_prefetch, infer_coro);
+    }
+    else
+    {
+      run_coro_with(ring_runner_without_prefetch, runner_without_prefetch, infer_coro_without_prefetch);
+    }
+  };
+
+  // Calibration slices run on the ring runner, each over the next 
+  // AUTOTUNE_SLICE_SENSORS sensors, so that the slices see the cache
+  // much as a full run does
+  // Ingest, timed per datagram
+  batch_ingester ingester(rt_data);
+  row_placer placer(rt_data, timer);
+  std::vector<std::vector<data_item_t> > ingest_buffers(rt.ingest_batch);
+  NanoTimer::timeres_t ingest_total = 0;
+  uint64_t ingest_count = 0;
+  uint64_t faulty_count = 0; // Saves rejected, from a lossy receiver
+
+  interleave_autotuner tuner;
+  uint32_t retune_count = 0;
+  size_t slice_first = 0;
+  auto autotune = [&](uint32_t iRepeat, int reason)
+  {
+    size_t slice_len = std::min<size_t>(AUTOTUNE_SLICE_SENSORS, rt.sensor_count);
+    // Slices score sensors too, but are not runs: early exit's bins are left as they were
+    uint64_t bins_touched = rt_data.bins_touched.load();
+    uint64_t bins_scored = rt_data.bins_scored.load();
+    tuner.start(rt_data.working_set_bytes(), autotune_task_counts);
+    while (tuner.tuning())
+    {
+      const autotune_candidate_t& candidate = tuner.next();
+      if (rt.suspend_lines_sized)
+      {
+        rt.suspend_lines = rt.suspend_lines_for(candidate.task_count);
+      }
+      auto run_slice = [&]()
+      {
+        sensor_slice_source source { slice_first, slice_len, rt.sensor_count };
+        if (candidate.prefetch)
+        {
+          ring_runner_with_prefetch.run_source(candidate.task_count, source, infer_coro);
+        }
+        else
+        {
+          ring_runner_without_prefetch.run_source(candidate.task_count, source, infer_coro_without_prefetch);
+        }
+      };
+      double cost = 0.0;
+      auto started_at = timer.get_timestamp();
+      if (rt.autotune_cycles)
+      {
+        pem_summaries[EMI_TUNE].clear();
+        perf_record(EMI_TUNE, run_slice);
+        cost = (double)pem_summaries[EMI_TUNE].extract_value(0);
+      }
+      else
+      {
+        run_slice();
+      }
+      auto finished_at = timer.get_timestamp();
+      // Without perf counters, cycles read as 0: fall back to time
+      bool cycles = (cost > 0.0);
+      if (!cycles)
+      {
+        cost = (double)(finished_at - started_at);
+      }
+      cost /= (double)slice_len;
+      autotune_trace_line(rt_data, iRepeat, tuner.round(), candidate, cycles, cost);
+      slice_first = (slice_first + slice_len) % rt.sensor_count;
+      tuner.record(cost);
+    }
+    rt_data.bins_touched.store(bins_touched);
+    rt_data.bins_scored.store(bins_scored);
+    coro_tasks = tuner.chosen().task_count;
+    coro_prefetch = tuner.chosen().prefetch;
+    if (rt.suspend_lines_sized)
+    {
+      rt.suspend_lines = rt.suspend_lines_for(coro_tasks);
+    }
+    autotune_chosen_line(rt_data, iRepeat, reason, tuner.chosen());
+  };
+  coroutine_symmetric_runner<prefetch_true, runtime_data> symmetric_runner_with_prefetch(prefetcher, rt_data);
+  auto infer_symmetric = (rt.kernel_type == SVM_KERNEL_LINEAR) 
+    ? infer_sensor_coro<prefetch_true, symmetric_task> : infer_sensor_kernel_coro<prefetch_true, symmetric_task>;
+  auto run_infer_symmetric = [&]()
+  {
+    symmetric_runner_with_prefetch.run(rt_data.rt.task_count, rt_data.rt.sensor_count, infer_symmetric);
+    coro_resumes += symmetric_runner_with_prefetch.switch_count();
+  };
+  // The thread pool is only started for the threads model
+  std::unique_ptr<thread_infer_runner> thread_runner;
+  if (rt.compare_model == EXEC_MODEL_THREADS)
+  {
+    thread_runner = std::make_unique<thread_infer_runner>(rt_data, rt.thread_count, infer_coro);
+  }
+  auto run_infer_threads = [&](size_t thread_count)
+  {
+    uint64_t resumes_before = thread_runner->resume_count();
+    thread_runner->run(thread_count);
+    coro_resumes += thread_runner->resume_count() - resumes_before;
+  };
+  // Each sensor is due its priority class's budget after its latest
+  // sample came in; classes are fixed for a repeat from the results of
+  // the one before. The run stands in for one that started as ingest
+  // ended, so a sensor is released as long before it as its sample came
+  // before the last of all.
+  deadline_source deadline_queue;
+  std::vector<uint8_t> priority_classes(rt.sensor_count, PRIORITY_CLASS_NORMAL);
+  deadline_stats_t deadline_totals[PRIORITY_CLASS_COUNT] = {};
+  uint32_t deadline_repeat = 0;
+  auto run_infer_deadline = [&]()
+  {
+    uint64_t started_at = deadline_clock_ns();
+    const uint64_t budgets[PRIORITY_CLASS_COUNT] = { 
+      1000ull * rt.alarm_deadline_us, 1000ull * rt.deadline_us };
+    uint64_t last_ready = *std::max_element(rt_data.ready_at.begin(), rt_data.ready_at.end());
+    deadline_queue.reset(rt.sensor_count);
+    for (size_t s = 0; s < rt.sensor_count; s++)
+    {
+      uint64_t waited = rt_data.ready_at[s] ? last_ready - rt_data.ready_at[s] : 0;
+      uint64_t released_at = started_at - waited;
+      deadline_queue.push(s, priority_classes[s], released_at, released_at + budgets[priority_classes[s]]);
+    }
+    ring_runner_with_prefetch.run_source(rt.task_count, deadline_queue, infer_coro);
+    coro_resumes += ring_runner_with_prefetch.resume_count();
+    for (int c = 0; c < PRIORITY_CLASS_COUNT; c++)
+    {
+      const deadline_stats_t& stats = deadline_queue.stats(c);
+      deadline_line(rt_data, deadline_repeat, c, stats);
+      deadline_totals[c].count += stats.count;
+      deadline_totals[c].misses += stats.misses;
+      deadline_totals[c].latency_total += stats.latency_total;
+      deadline_totals[c].latency_max = std::max(deadline_totals[c].latency_max, stats.latency_max);
+    }
+  };
   #endif
+  NanoTimer::timeres_t coro_span_total = 0;
+
+  auto run_model = [&](int exec_model)
+  {
+    switch (exec_model)
+    {
+    case EXEC_MODEL_SEQ:
+      run_infer_sequential(rt_data);
+      break;
+    case EXEC_MODEL_CORO:
+      #ifndef USE_GENERIC_COROUTINE_RUNNER
+      run_infer_coroutine(rt_data);
+      #else
+      run_infer_coro();
+      #endif
+      break;
+    case EXEC_MODEL_SYMMETRIC:
+      run_infer_symmetric();
+      break;
+    case EXEC_MODEL_THREADS:
+      run_infer_threads(rt.thread_count);
+      break;
+    case EXEC_MODEL_AMAC:
+      coro_resumes += run_infer_amac(rt_data);
+      break;
+    case EXEC_MODEL_PIPELINED:
+      run_infer_pipelined(rt_data);
+      break;
+    case EXEC_MODEL_DEADLINE:
+      run_infer_deadline();
+      break;
+    }
+  };
 
   // Run rt.repeats times
   for (uint32_t iRepeat = 0; iRepeat < rt.repeats; iRepeat++) 
@@ -1221,11 +3926,45 @@ int main(int argc, char **argv)
     receiver->reset();
     rt_data.reset_seq_ids();
 
-    // Collect and organise input
-    std::vector<data_item_t> input_buffer;
-    while (receiver->get_next_input(input_buffer))
+    // Collect and organise input, ingest_batch datagrams at a time
+    size_t batched = 0;
+    bool more = true;
+    while (more)
     {
-      if (!rt_data.save_input_data(input_buffer)) {
+      size_t rejected = 0;
+      if (rt.ingest_batch == 1)
+      {
+        // Each payload is written once, into its row
+        bool ok = true;
+        more = receiver->place_next_input(placer, ok);
+        if (!more)
+        {
+          break;
+        }
+        ingest_total += timer.get_timestamp() - placer.placed_at();
+        ingest_count++;
+        rejected = ok ? 0 : 1;
+      }
+      else
+      {
+        more = receiver->get_next_input(ingest_buffers[batched]);
+        batched += more ? 1 : 0;
+        if (batched == 0 || (more && batched < rt.ingest_batch))
+        {
+          continue;
+        }
+        auto ingest_started_at = timer.get_timestamp();
+        rejected = ingester.save(ingest_buffers.data(), batched);
+        ingest_total += timer.get_timestamp() - ingest_started_at;
+        ingest_count += batched;
+        batched = 0;
+      }
+      if (rejected > 0) {
+        // Datagrams lost on the way leave gaps in the sequence
+        if (receiver->lossy()) {
+          faulty_count += rejected;
+          continue;
+        }
         std::cerr << "Faulty input received\r\n";
         return 2;
       }
@@ -1234,6 +3973,30 @@ int main(int argc, char **argv)
     {
       break;
     }
+    int requested_pattern;
+    if (receiver->pattern_requested(requested_pattern))
+    {
+      rt.exec_pattern = requested_pattern;
+      rt.exec_model = (requested_pattern == EXEC_PATTERN_SEQ) ? EXEC_MODEL_SEQ : rt.compare_model;
+    }
+
+    // Priorities for this repeat, from the results of the last
+    if (rt.compare_model == EXEC_MODEL_DEADLINE)
+    {
+      deadline_repeat = iRepeat;
+      for (size_t s = 0; s < rt.sensor_count; s++)
+      {
+        priority_classes[s] = (uint8_t)rt_data.priority_class(s);
+      }
+    }
+
+    // Tune on the data just received, before any timed run
+    int retune_reason;
+    if (rt.autotune && tuner.should_retune(rt_data.working_set_bytes(), retune_reason))
+    {
+      retune_count += (retune_reason == AUTOTUNE_REASON_START) ? 0 : 1;
+      autotune(iRepeat, retune_reason);
+    }
 
     // Infer all rows
     if (rt.exec_pattern == EXEC_PATTERN_BOTH)
@@ -1241,35 +4004,32 @@ int main(int argc, char **argv)
       ::clear_cache();
       NanoTimer::timeres_t spans[3];
       // Run 3 models as follows:
-      //  EXEC_MODEL_SEQ, EXEC_MODEL_CORO, EXEC_MODEL_SEQ
+      //  EXEC_MODEL_SEQ, compare_model, EXEC_MODEL_SEQ
       for (int iModel = 0; iModel < 3; iModel++)
       {
         // Wait 1/10th second to clarify any hysteresis on the power use
         sys_wait_us(1000 * rt.between_ms);
 
-        int exec_model = (iModel == 1) ? EXEC_MODEL_CORO : EXEC_MODEL_SEQ;
-        the_gpio.set(exec_model, true);
+        int exec_model = (iModel == 1) ? rt.compare_model : EXEC_MODEL_SEQ;
+        the_gpio.set(GPIO_PIN(exec_model), true);
         auto started_at = timer.get_timestamp();
         //start perf_record
-        perf_record(iModel, [&exec_model, &rt_data, &runner_with_prefetch]()
+        perf_record(iModel, [&exec_model, &run_model]()
         {
-          if (exec_model == EXEC_MODEL_SEQ)
-          {
-            run_infer_sequential(rt_data);
-          }
-          else
-          {
-            #ifndef USE_GENERIC_COROUTINE_RUNNER
-            run_infer_coroutine(rt_data);
-            #else
-            runner_with_prefetch.run(rt_data.rt.task_count, rt_data.rt.sensor_count, infer_sensor_coro);
-            #endif
-          }
+          run_model(exec_model);
         });
         //end perf_record
         auto finished_at = timer.get_timestamp();
-        the_gpio.set(exec_model, false);
+        the_gpio.set(GPIO_PIN(exec_model), false);
         spans[iModel] = finished_at - started_at;
+        if (rt.autotune && exec_model == EXEC_MODEL_CORO)
+        {
+          tuner.observe((double)spans[iModel]);
+        }
+        if (exec_model != EXEC_MODEL_SEQ)
+        {
+          coro_span_total += spans[iModel];
+        }
         perf_line(rt_data, iRepeat, iModel, exec_model);
 
         if (rt.verbosity > 1)
@@ -1285,34 +4045,59 @@ int main(int argc, char **argv)
         }
 
         if (iModel == 2) {
+          // Time the threads model on 1 to thread_count threads
+          std::vector<NanoTimer::timeres_t> scaling_spans;
+          if (thread_runner)
+          {
+            for (uint16_t t = 1; t <= rt.thread_count; t++)
+            {
+              sys_wait_us(1000 * rt.between_ms);
+              the_gpio.set(GPIO_PIN(EXEC_MODEL_THREADS), true);
+              auto scaling_started_at = timer.get_timestamp();
+              // Not run_infer_threads(): these resumes are not in coro_span_total
+              thread_runner->run(t);
+              auto scaling_finished_at = timer.get_timestamp();
+              the_gpio.set(GPIO_PIN(EXEC_MODEL_THREADS), false);
+              scaling_spans.push_back(scaling_finished_at - scaling_started_at);
+            }
+          }
           float ratios[2] = { (float)spans[0]/(float)spans[1], (float)spans[2]/(float)spans[1] };
           if (rt.verbosity > 0)
           {
-            report_three(rt_data, spans, 3, ratios);
+            report_three(rt_data, spans, 3, ratios, scaling_spans);
           }
           ratio_count++;
           ratio_totals[0] += ratios[0];
           ratio_totals[1] += ratios[1];
         }
       }
+      if (rt.weights_format == WEIGHTS_INT8)
+      {
+        rt_data.check_q8_accuracy();
+      }
       sys_wait_us(1000 * rt.between_ms);
     }
     else
     {
-      the_gpio.set(rt.exec_model, true);
+      the_gpio.set(GPIO_PIN(rt.exec_model), true);
       auto started_at = timer.get_timestamp();
       //start perf_record
-      if (rt.exec_model == EXEC_MODEL_SEQ)
+      run_model(rt.exec_model);
+      //end perf_record
+      auto finished_at = timer.get_timestamp();
+      if (pacer)
       {
-        run_infer_sequential(rt_data);
+        pacer->complete_period(deadline_clock_ns(), latencies);
       }
-      else
+      if (rt.autotune && rt.exec_model == EXEC_MODEL_CORO)
       {
-        runner_with_prefetch.run(rt_data.rt.task_count, rt_data.rt.sensor_count, infer_sensor_coro);
+        tuner.observe((double)(finished_at - started_at));
       }
-      //end perf_record
-      auto finished_at = timer.get_timestamp();
-      the_gpio.set(rt.exec_model, false);
+      if (rt.exec_model != EXEC_MODEL_SEQ)
+      {
+        coro_span_total += finished_at - started_at;
+      }
+      the_gpio.set(GPIO_PIN(rt.exec_model), false);
       if (rt.verbosity > 0)
       {
         report_one(rt_data, rt.exec_model, finished_at - started_at);
@@ -1323,6 +4108,10 @@ int main(int argc, char **argv)
           dump_vector(v, std::cout, "results");
         }
       }
+      if (rt.weights_format == WEIGHTS_INT8)
+      {
+        rt_data.check_q8_accuracy();
+      }
     }
   }
 
@@ -1334,10 +4123,56 @@ int main(int argc, char **argv)
     std::cout << "sensors," << rt.sensor_count
               << ",samples," << rt.sample_count 
               << ",datagram," << rt.datagram_size
-              << ",tasks," << rt.task_count
-              << ",ratio0," << ratio_totals[0]/(float)ratio_count 
-              << ",ratio1," << ratio_totals[1]/(float)ratio_count 
+              << ",tasks," << coro_tasks
+              << ",prefetch," << coro_prefetch
+              << ",suspend_lines," << rt.suspend_lines
+              << ",autotune," << rt.autotune
+              << ",ingest_batch," << rt.ingest_batch
+              << ",ingest_ns," << (ingest_count ? (double)ingest_total / (double)ingest_count : 0.0)
+              << ",faulty," << faulty_count
+              << ",datagrams_per_s," << (network ? network->datagrams_per_second() : 0.0)
+              << ",syscalls_per_datagram," << (network ? network->syscalls_per_datagram() : 0.0)
+              << ",malformed," << (network ? network->malformed_count() : 0)
+              << ",recv_backend," << (network ? network->backend_name() : "none")
+              << ",cpu_us_per_100k," << (network ? network->cpu_us_per_100k() : 0.0)
+              << ",offered_rate," << rt.rate
+              << ",achieved_rate," << (pacer ? pacer->achieved_rate() : 0.0)
+              << ",late," << (pacer ? pacer->late_count() : 0)
+              << ",latency_p50_ns," << latencies.percentile(50.0)
+              << ",latency_p90_ns," << latencies.percentile(90.0)
+              << ",latency_p99_ns," << latencies.percentile(99.0)
+              << ",latency_p999_ns," << latencies.percentile(99.9)
+              << ",latency_max_ns," << latencies.max()
+              << ",retunes," << retune_count
+              << ",exec_model," << exec_model_names[rt.compare_model]
+              << ",threads," << (thread_runner ? rt.thread_count : 1)
+              << ",steals," << (thread_runner ? thread_runner->steal_count() : 0);
+    for (int c = 0; rt.compare_model == EXEC_MODEL_DEADLINE && c < PRIORITY_CLASS_COUNT; c++)
+    {
+      std::cout << sep << priority_class_name(c) << "_sensors" << sep << deadline_totals[c].count
+                << sep << priority_class_name(c) << "_misses" << sep << deadline_totals[c].misses
+                << sep << priority_class_name(c) << "_latency_ns" << sep << deadline_totals[c].mean_latency();
+    }
+    std::cout
+              << ",runner," << runner_names[rt.runner]
+              << ",ns_per_resume," << (coro_resumes ? (double)coro_span_total / (double)coro_resumes : 0.0)
+              << ",frames_created," << frame_pool.created() + (thread_runner ? thread_runner->frames_created() : 0)
+              << ",frames_recycled," << frame_pool.recycled() + (thread_runner ? thread_runner->frames_recycled() : 0)
+              << ",block," << rt.block_size
+              << ",classes," << rt.class_count
+              << ",kernel," << svm_kernel_name(rt.kernel_type)
+              << ",isa," << svm_isa_name(rt.isa)
+              << ",fixed_length," << rt.fixed_length
+              << ",accumulator," << accumulator_names[rt.accumulator]
+              << ",weights," << weights_format_names[rt.weights_format]
+              << ",agreement," << rt_data.q8_agreement()
+              << ",sparse," << rt_data.weights_sparse.sparse_count
+              << ",early_exit," << rt.early_exit
+              << ",touched," << rt_data.touched_fraction()
+              << ",ratio0," << (ratio_count ? ratio_totals[0]/(float)ratio_count : 0.0f)
+              << ",ratio1," << (ratio_count ? ratio_totals[1]/(float)ratio_count : 0.0f)
               << std::endl;
   }
   return 0;
 }
+#endif
@@ -0,0 +1,17 @@
+#!/bin/bash
+# Compares the resumable runner, symmetric transfer between coroutines
+# and AMAC state machines for a range of task counts. Prints the mean interleaved
+# span in ns, skipping the first repeat.
+# Usage: bench_exec_models.sh [path to infer7] [extra infer7 args...]
+
+INFER7=${1:-./build/infer7}
+shift
+
+echo "tasks,model,coro"
+for TASKS in 2 4 8 16; do
+  for MODEL in coro symmetric amac; do
+    "$INFER7" -i -s 2000 -c 20 -d 512 -t $TASKS -a 11 -e 0 -v 1 -k --exec_model $MODEL "$@" \
+      | awk -F, -v t=$TASKS -v m=$MODEL '/^[0-9]/ { if (n++ > 0) { coro += $5 } }
+          END { printf "%s,%s,%.0f\n", t, m, coro / (n - 1) }'
+  done
+done
@@ -0,0 +1,22 @@
+#!/bin/bash
+# Compares kernels specialised for the support vector length with the
+# generic-length kernels, for each datagram size that has one. Prints
+# the mean coroutine and (warm) sequential spans in ns, skipping the
+# first repeat.
+# Usage: bench_fixed_length.sh [path to infer7] [extra infer7 args...]
+
+INFER7=${1:-./build/infer7}
+shift
+
+echo "datagram,kernel,coro,seq1"
+for DATAGRAM in 512 1024 2048; do
+  for MODE in fixed generic; do
+    FLAG=""
+    if [ "$MODE" = "generic" ]; then
+      FLAG="--generic_length"
+    fi
+    "$INFER7" -i -s 2000 -c 20 -d $DATAGRAM -t 4 -a 11 -e 0 -v 1 -k $FLAG "$@" \
+      | awk -F, -v d=$DATAGRAM -v m=$MODE '/^[0-9]/ { if (n++ > 0) { coro += $5; seq1 += $6 } }
+          END { printf "%s,%s,%.0f,%.0f\n", d, m, coro / (n - 1), seq1 / (n - 1) }'
+  done
+done
@@ -0,0 +1,22 @@
+#!/bin/bash
+# Compares saving each datagram on arrival with batched, interleaved
+# ingest, for a cache-resident and a large sensor population. Prints
+# the mean ingest time per datagram in ns. Each population is recorded
+# once and replayed (-u), so that every batch size copies the same
+# datagrams from the same place: simulated input is generated straight
+# into its rows when saved on arrival.
+# Usage: bench_ingest.sh [path to infer7] [extra infer7 args...]
+
+INFER7=${1:-./build/infer7}
+shift
+CAPTURE=/tmp/bench_ingest.$$.cap
+
+echo "sensors,ingest_batch,ingest_ns"
+for SENSORS in 2000 50000; do
+  "$INFER7" -i -s $SENSORS -c 4 -d 512 -t 4 -a 1 -e 0 -v 0 --record $CAPTURE "$@" > /dev/null
+  for BATCH in 1 4 8 16 32; do
+    "$INFER7" -i -s $SENSORS -c 4 -d 512 -t 4 -a 5 -e 0 -v 1 -u $CAPTURE --ingest_batch $BATCH "$@" \
+      | tail -1 | awk -F, -v s=$SENSORS -v b=$BATCH '{ for (i = 1; i < NF; i++) if ($i == "ingest_ns") print s "," b "," $(i + 1) }'
+  done
+done
+rm -f $CAPTURE
@@ -0,0 +1,21 @@
+#!/bin/bash
+# Offers infer7 simulated input at a range of open-loop rates (--rate)
+# and prints, for each, the achieved throughput and the latency
+# percentiles from intended arrival to inference result, to find the
+# rate at which latency starts to grow without bound.
+# Usage: bench_load_sweep.sh [build dir] [extra infer7 args...]
+
+BUILD=${1:-./build}
+shift
+SIZE=${SIZE:-"-s 200 -c 20 -d 512"}
+RATES=${RATES:-"10000 20000 50000 100000 200000 500000"}
+REPEATS=${REPEATS:-10}
+
+echo "offered_rate,achieved_rate,late,latency_p50_us,latency_p90_us,latency_p99_us,latency_p999_us,latency_max_us"
+for RATE in $RATES; do
+  "$BUILD/infer7" -i $SIZE -t 8 -a $REPEATS -e 0 -v 1 --rate $RATE "$@" | tail -1 | awk -F, '{
+      for (i = 1; i < NF; i += 2) { v[$i] = $(i + 1) }
+      printf "%s,%.0f,%s,%.1f,%.1f,%.1f,%.1f,%.1f\n", v["offered_rate"], v["achieved_rate"], v["late"],
+        v["latency_p50_ns"] / 1000, v["latency_p90_ns"] / 1000, v["latency_p99_ns"] / 1000,
+        v["latency_p999_ns"] / 1000, v["latency_max_ns"] / 1000 }'
+done
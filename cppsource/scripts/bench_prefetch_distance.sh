@@ -0,0 +1,21 @@
+#!/bin/bash
+# Times the software-pipelined sequential model over a range of
+# prefetch distances, against the coroutine model. Prints the mean
+# span of the model and of the (warm) plain sequential run in ns,
+# skipping the first repeat.
+# Usage: bench_prefetch_distance.sh [path to infer7] [extra infer7 args...]
+
+INFER7=${1:-./build/infer7}
+shift
+
+run() {
+  "$INFER7" -i -s 2000 -c 20 -d 512 -t 8 -a 11 -e 0 -v 1 -k "$@" \
+    | awk -F, '/^[0-9]/ { if (n++ > 0) { model += $5; seq1 += $6 } }
+        END { printf "%.0f,%.0f\n", model / (n - 1), seq1 / (n - 1) }'
+}
+
+echo "model,distance,span,seq1"
+echo "coro,-,$(run --exec_model coro "$@")"
+for DISTANCE in 0 1 2 4 8 16; do
+  echo "pipelined,$DISTANCE,$(run --exec_model pipelined --prefetch_distance $DISTANCE "$@")"
+done
@@ -0,0 +1,23 @@
+#!/bin/bash
+# Times the coroutine model over a range of suspension budgets (lines
+# prefetched per suspension), for short, medium and long datagrams.
+# Prints the mean span of the model and of the (warm) plain sequential
+# run in ns, skipping the first repeat. A budget of 0 is sized from the
+# L1 data cache.
+# Usage: bench_suspend_lines.sh [path to infer7] [extra infer7 args...]
+
+INFER7=${1:-./build/infer7}
+shift
+
+run() {
+  "$INFER7" -i -s 2000 -c 20 -t 8 -a 11 -e 0 -v 1 -k "$@" \
+    | awk -F, '/^[0-9]/ { if (n++ > 0) { model += $5; seq1 += $6 } }
+        END { printf "%.0f,%.0f\n", model / (n - 1), seq1 / (n - 1) }'
+}
+
+echo "datagram,suspend_lines,span,seq1"
+for DATAGRAM in 64 512 8192; do
+  for LINES in 0 1 2 4 8 16 32 64 128; do
+    echo "$DATAGRAM,$LINES,$(run -d $DATAGRAM --suspend_lines $LINES "$@")"
+  done
+done
@@ -0,0 +1,28 @@
+#!/bin/bash
+# Runs infer7 as a UDP server on loopback and feeds it from transmit,
+# for each receive backend and a range of batch sizes. Prints the
+# receive rate, the syscalls per datagram and the receive and ingest CPU
+# time per 100k datagrams from infer7's summary line.
+# Usage: bench_udp_loopback.sh [build dir] [extra infer7 args...]
+
+BUILD=${1:-./build}
+shift
+PORT=${PORT:-9123}
+SIZE=${SIZE:-"-s 2000 -c 20 -d 512"}
+REPEATS=5
+
+echo "recv_backend,recv_batch,datagrams_per_s,syscalls_per_datagram,cpu_us_per_100k,faulty"
+for BACKEND in recvmmsg io_uring; do
+for BATCH in 1 8 64 256; do
+  "$BUILD/infer7" -i $SIZE -t 8 -a $REPEATS -e 0 -v 1 -k -p $PORT --recv_batch $BATCH --recv_backend $BACKEND "$@" > /tmp/infer7_udp.$$ &
+  SERVER=$!
+  sleep 1
+  "$BUILD/transmit" $SIZE -a $REPEATS -p $PORT -e 200 -v 0
+  wait $SERVER
+  tail -1 /tmp/infer7_udp.$$ | awk -F, -v batch=$BATCH '{
+      for (i = 1; i < NF; i += 2) { v[$i] = $(i + 1) }
+      printf "%s,%s,%s,%s,%s,%s\n", v["recv_backend"], batch, v["datagrams_per_s"],
+        v["syscalls_per_datagram"], v["cpu_us_per_100k"], v["faulty"] }'
+done
+done
+rm -f /tmp/infer7_udp.$$
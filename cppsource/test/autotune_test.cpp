@@ -0,0 +1,50 @@
+#include "autotune.h"
+#include <gtest/gtest.h>
+#include <cstdlib>
+
+// A noisy cost with its minimum at 8 tasks with prefetch
+static double synthetic_cost(const autotune_candidate_t& c)
+{
+  double cost = 100.0 + std::abs((int)c.task_count - 8) * 10.0 + (c.prefetch ? 0.0 : 30.0);
+  return cost + (std::rand() % 5);
+}
+
+TEST(Autotune, Converges_on_cheapest) {
+  std::srand(1);
+  interleave_autotuner tuner;
+  int reason;
+  ASSERT_TRUE(tuner.should_retune(1000, reason));
+  EXPECT_EQ(reason, AUTOTUNE_REASON_START);
+  tuner.start(1000, { 1, 2, 4, 8, 12, 16 });
+  size_t slices = 0;
+  while (tuner.tuning())
+  {
+    tuner.record(synthetic_cost(tuner.next()));
+    slices++;
+  }
+  EXPECT_EQ(tuner.chosen().task_count, 8);
+  EXPECT_TRUE(tuner.chosen().prefetch);
+  // 12 + 6 + 3 + 2 candidates
+  EXPECT_EQ(slices, 23u);
+  EXPECT_FALSE(tuner.should_retune(1000, reason));
+}
+
+TEST(Autotune, Retunes_on_change) {
+  interleave_autotuner tuner(0.25);
+  tuner.start(1000, { 4 });
+  int reason;
+  EXPECT_FALSE(tuner.should_retune(1200, reason));
+  ASSERT_TRUE(tuner.should_retune(2000, reason));
+  EXPECT_EQ(reason, AUTOTUNE_REASON_WORKING_SET);
+
+  // One slow run is noise; two in a row are drift
+  tuner.observe(100.0);
+  tuner.observe(200.0);
+  EXPECT_FALSE(tuner.should_retune(1000, reason));
+  tuner.observe(110.0);
+  tuner.observe(200.0);
+  EXPECT_FALSE(tuner.should_retune(1000, reason));
+  tuner.observe(200.0);
+  ASSERT_TRUE(tuner.should_retune(1000, reason));
+  EXPECT_EQ(reason, AUTOTUNE_REASON_DRIFT);
+}
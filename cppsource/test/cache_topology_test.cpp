@@ -0,0 +1,57 @@
+#include "cache_topology.h"
+#include <gtest/gtest.h>
+
+TEST(CacheTopology, Parses_sysfs_sizes) {
+  EXPECT_EQ(parse_cache_size("48K"), 48u * 1024);
+  EXPECT_EQ(parse_cache_size("32M"), 32u * 1024 * 1024);
+  EXPECT_EQ(parse_cache_size("512"), 512u);
+  EXPECT_EQ(parse_cache_size(""), 0u);
+}
+
+TEST(CacheTopology, Levels_set_l1d_l2_and_llc) {
+  cache_topology_t topology;
+  topology.levels = { { 3, 8u << 20, 64 }, { 1, 32u << 10, 128 }, { 2, 1u << 20, 64 } };
+  cache_topology_from_levels(topology);
+  EXPECT_EQ(topology.line_size, 128u);
+  EXPECT_EQ(topology.l1d, 32u << 10);
+  EXPECT_EQ(topology.l2, 1u << 20);
+  EXPECT_EQ(topology.llc, 8u << 20);
+}
+
+TEST(CacheTopology, Missing_levels_keep_their_defaults) {
+  cache_topology_t topology;
+  topology.levels = { { 1, 48u << 10, 64 } };
+  cache_topology_from_levels(topology);
+  EXPECT_EQ(topology.l1d, 48u << 10);
+  EXPECT_EQ(topology.l2, (size_t)CACHE_TOPOLOGY_DEFAULT_L2);
+  EXPECT_EQ(topology.llc, (size_t)CACHE_TOPOLOGY_DEFAULT_LLC);
+
+  // No L3: the L2 is not taken for the last level
+  topology = cache_topology_t();
+  topology.levels = { { 1, 32u << 10, 64 }, { 2, 256u << 10, 64 } };
+  cache_topology_from_levels(topology);
+  EXPECT_EQ(topology.l2, 256u << 10);
+  EXPECT_EQ(topology.llc, (size_t)CACHE_TOPOLOGY_DEFAULT_LLC);
+}
+
+TEST(CacheTopology, Levels_are_ordered_by_size) {
+  // An L2 larger than the default last level raises it
+  cache_topology_t topology;
+  topology.levels = { { 1, 64u << 10, 64 }, { 2, 16u << 20, 64 } };
+  cache_topology_from_levels(topology);
+  EXPECT_EQ(topology.llc, 16u << 20);
+
+  // Only an L1, larger than the default L2
+  topology = cache_topology_t();
+  topology.levels = { { 1, 1u << 20, 64 } };
+  cache_topology_from_levels(topology);
+  EXPECT_EQ(topology.l2, 1u << 20);
+  EXPECT_EQ(topology.llc, (size_t)CACHE_TOPOLOGY_DEFAULT_LLC);
+}
+
+TEST(CacheTopology, Highest_level_is_the_last) {
+  cache_topology_t topology;
+  topology.levels = { { 4, 128u << 20, 64 }, { 1, 32u << 10, 64 }, { 3, 8u << 20, 64 }, { 2, 1u << 20, 64 } };
+  cache_topology_from_levels(topology);
+  EXPECT_EQ(topology.llc, 128u << 20);
+}
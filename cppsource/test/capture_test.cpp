@@ -0,0 +1,71 @@
+#include "capture.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static std::string temp_path(const char* name)
+{
+  return std::string(::testing::TempDir()) + name;
+}
+
+TEST(Capture, Round_trips_records_and_periods) {
+  std::string path = temp_path("capture_round_trip.bin");
+  std::vector<uint8_t> ids(3 * CAPTURE_ID_BYTES);
+  for (size_t i = 0; i < ids.size(); i++) {
+    ids[i] = (uint8_t)i;
+  }
+  {
+    capture_writer writer(path, ids.data(), 3, 2, 100);
+    std::vector<char> datagram(100);
+    for (int i = 0; i < 5; i++) {
+      datagram[0] = (char)i;
+      datagram[99] = (char)(i + 100);
+      writer.write(datagram.data());
+      if (i == 2) {
+        writer.end_period();
+        writer.end_period(); // Empty periods are not recorded
+      }
+    }
+  }
+  capture_file file(path);
+  const capture_header_t& h = file.header();
+  EXPECT_EQ(h.datagram_size, 100u);
+  EXPECT_EQ(h.sensor_count, 3u);
+  EXPECT_EQ(h.sample_count, 2u);
+  EXPECT_EQ(h.record_stride, 128u);
+  EXPECT_EQ(h.record_offset % CAPTURE_DATA_ALIGN, 0u);
+  EXPECT_EQ(h.record_count, 5u);
+  ASSERT_EQ(h.period_count, 2u);
+  EXPECT_EQ(file.period_begin(0), 0u);
+  EXPECT_EQ(file.period_end(0), 3u);
+  EXPECT_EQ(file.period_begin(1), 3u);
+  EXPECT_EQ(file.period_end(1), 5u);
+  EXPECT_EQ(memcmp(file.sensor_id(0), ids.data(), ids.size()), 0);
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(file.record(i)[0], (char)i);
+    EXPECT_EQ(file.record(i)[99], (char)(i + 100));
+    EXPECT_EQ((uintptr_t)file.record(i) % CAPTURE_RECORD_ALIGN, 0u);
+  }
+  std::remove(path.c_str());
+}
+
+TEST(Capture, Rejects_other_and_truncated_files) {
+  std::string path = temp_path("capture_bad.bin");
+  {
+    std::ofstream os(path, std::ios::binary);
+    os << std::string(200, 'x');
+  }
+  EXPECT_THROW(capture_file file(path), std::runtime_error);
+  {
+    uint8_t id[CAPTURE_ID_BYTES] = {};
+    capture_writer writer(path, id, 1, 1, 64);
+    std::vector<char> datagram(64, 1);
+    writer.write(datagram.data());
+  }
+  // Cut off inside the records
+  ASSERT_EQ(truncate(path.c_str(), CAPTURE_DATA_ALIGN + 32), 0);
+  EXPECT_THROW(capture_file file(path), std::runtime_error);
+  std::remove(path.c_str());
+  EXPECT_THROW(capture_file file(path), std::runtime_error);
+}
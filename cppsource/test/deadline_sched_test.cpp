@@ -0,0 +1,87 @@
+#include "resumable.h"
+#include "run_coro.h"
+#include "prefetch1.h"
+#include "deadline_sched.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+struct launch_data {
+  std::vector<size_t> order;
+};
+
+static resumable launch_coro(const prefetch_false&, launch_data& data, size_t index)
+{
+  data.order.push_back(index);
+  co_await suspend_always{};
+}
+
+TEST(Deadline_sched, Earliest_deadline_first) {
+  deadline_source source;
+  source.reset(5);
+  source.push(0, PRIORITY_CLASS_NORMAL, 0, 500);
+  source.push(1, PRIORITY_CLASS_ALARM, 0, 100);
+  source.push(2, PRIORITY_CLASS_NORMAL, 0, 500);
+  source.push(3, PRIORITY_CLASS_ALARM, 0, 50);
+  source.push(4, PRIORITY_CLASS_NORMAL, 0, 200);
+  std::vector<size_t> order;
+  size_t item;
+  while (source.next(item)) {
+    order.push_back(item);
+  }
+  EXPECT_EQ(order, (std::vector<size_t>{ 3, 1, 4, 0, 2 }));
+}
+
+TEST(Deadline_sched, Ring_runner_reports_per_class) {
+  prefetch_false prefetcher;
+  launch_data data;
+  coroutine_ring_runner<prefetch_false, launch_data> runner(prefetcher, data);
+  deadline_source source;
+  uint64_t now = deadline_clock_ns();
+  source.reset(10);
+  for (size_t i = 0; i < 10; i++) {
+    // Odd items are alarms, due at once, so all are late; the rest are not due for an hour
+    bool alarm = (i % 2) == 1;
+    source.push(i, alarm ? PRIORITY_CLASS_ALARM : PRIORITY_CLASS_NORMAL, now,
+      alarm ? now : now + 3600ull * 1000000000ull);
+  }
+  runner.run_source(1, source, launch_coro);
+  EXPECT_EQ(data.order, (std::vector<size_t>{ 1, 3, 5, 7, 9, 0, 2, 4, 6, 8 }));
+  EXPECT_EQ(source.stats(PRIORITY_CLASS_ALARM).count, 5u);
+  EXPECT_EQ(source.stats(PRIORITY_CLASS_ALARM).misses, 5u);
+  EXPECT_EQ(source.stats(PRIORITY_CLASS_NORMAL).count, 5u);
+  EXPECT_EQ(source.stats(PRIORITY_CLASS_NORMAL).misses, 0u);
+  EXPECT_LE(source.stats(PRIORITY_CLASS_ALARM).mean_latency(), source.stats(PRIORITY_CLASS_NORMAL).mean_latency());
+}
+
+TEST(Deadline_sched, Deadlines_interleave_classes_by_release) {
+  // Normal items released long enough ago are due before alarms released now,
+  // and within a class the earlier release goes first
+  const uint64_t alarm_budget = 100, normal_budget = 1000;
+  deadline_source source;
+  source.reset(4);
+  source.push(0, PRIORITY_CLASS_ALARM, 5000, 5000 + alarm_budget);
+  source.push(1, PRIORITY_CLASS_NORMAL, 4000, 4000 + normal_budget);
+  source.push(2, PRIORITY_CLASS_NORMAL, 3000, 3000 + normal_budget);
+  source.push(3, PRIORITY_CLASS_ALARM, 4990, 4990 + alarm_budget);
+  std::vector<size_t> order;
+  size_t item;
+  while (source.next(item)) {
+    order.push_back(item);
+  }
+  EXPECT_EQ(order, (std::vector<size_t>{ 2, 1, 3, 0 }));
+}
+
+TEST(Deadline_sched, Latency_runs_from_release) {
+  prefetch_false prefetcher;
+  launch_data data;
+  coroutine_ring_runner<prefetch_false, launch_data> runner(prefetcher, data);
+  deadline_source source;
+  uint64_t now = deadline_clock_ns();
+  const uint64_t second = 1000000000ull;
+  source.reset(2);
+  source.push(0, PRIORITY_CLASS_ALARM, now, now + 3600 * second);
+  source.push(1, PRIORITY_CLASS_NORMAL, now - 10 * second, now + 3600 * second);
+  runner.run_source(1, source, launch_coro);
+  EXPECT_LT(source.stats(PRIORITY_CLASS_ALARM).latency_max, 10 * second);
+  EXPECT_GE(source.stats(PRIORITY_CLASS_NORMAL).latency_max, 10 * second);
+}
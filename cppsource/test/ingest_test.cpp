@@ -0,0 +1,87 @@
+// The ingest paths of infer7.cpp, built without its main()
+#include "../infer7.cpp"
+#include <gtest/gtest.h>
+
+// Settings as infer7 would parse them, for a few small sensors
+static void small_settings(run_time_settings_t& rt)
+{
+  rt.topology = discover_cache_topology();
+  pf_line_size = rt.topology.line_size;
+  const char* args[] = { "infer7", "-s", "6", "-c", "4", "-d", "96", "-i" };
+  ASSERT_TRUE(parse_cmd_line(8, const_cast<char**>(args), rt));
+}
+
+// A datagram for sensor s, or for an unknown sensor if s is out of
+// range, with every payload byte set to fill
+static std::vector<data_item_t> make_datagram(const runtime_data& rt_data, size_t s, uint32_t seq_id, int fill)
+{
+  std::vector<data_item_t> buffer(rt_data.rt.datagram_size / sizeof(data_item_t));
+  datagram_t* d = reinterpret_cast<datagram_t*>(buffer.data());
+  if (s < rt_data.source_sensor_ids.size()) {
+    d->sensor_id = rt_data.source_sensor_ids[s];
+  } else {
+    memset(static_cast<void*>(&d->sensor_id), 0xA5, sizeof(d->sensor_id));
+  }
+  d->seq_id = seq_id;
+  memset(static_cast<void*>(d->data), fill, rt_data.rt.sv_len * sizeof(data_item_t));
+  return buffer;
+}
+
+static void clear_input(runtime_data& rt_data)
+{
+  rt_data.reset_seq_ids();
+  for (auto& v : rt_data.sensor_data) {
+    memset(static_cast<void*>(v.data()), 0, v.size() * sizeof(data_item_t));
+  }
+}
+
+TEST(Ingest, Batched_matches_serial) {
+  run_time_settings_t rt;
+  small_settings(rt);
+  ASSERT_EQ(rt.sample_count, 4u);
+  runtime_data rt_data(rt);
+  rt_data.initialise();
+
+  // Good datagrams among an unknown sensor, out-of-order and repeated
+  // sequence IDs, and a sequence ID past sample_count that is the one
+  // the sensor expects next
+  std::vector<std::vector<data_item_t> > buffers;
+  int fill = 1;
+  auto add = [&](size_t s, uint32_t seq_id) { buffers.push_back(make_datagram(rt_data, s, seq_id, fill++)); };
+  add(0, 0);
+  add(1, 0);
+  add(99, 0);
+  add(0, 2);
+  add(0, 1);
+  add(1, 0);
+  for (uint32_t seq_id = 0; seq_id <= rt.sample_count; seq_id++) {
+    add(3, seq_id);
+  }
+  add(2, 0);
+  add(4, 1);
+
+  clear_input(rt_data);
+  std::vector<bool> serial_ok;
+  for (const auto& buffer : buffers) {
+    serial_ok.push_back(rt_data.save_input_data(buffer));
+  }
+  std::vector<data_vector_t> serial_data = rt_data.sensor_data;
+  std::vector<id_t> serial_seq_ids = rt_data.seq_ids;
+  EXPECT_EQ(std::count(serial_ok.begin(), serial_ok.end(), false), 5);
+
+  batch_ingester ingester(rt_data);
+  for (size_t batch : {1, 3, 8, 64}) {
+    clear_input(rt_data);
+    size_t rejected = 0;
+    for (size_t first = 0; first < buffers.size(); first += batch) {
+      size_t count = std::min(batch, buffers.size() - first);
+      rejected += ingester.save(buffers.data() + first, count);
+      for (size_t i = 0; i < count; i++) {
+        EXPECT_EQ(ingester.accepted(i), serial_ok[first + i]) << "batch=" << batch << " datagram=" << first + i;
+      }
+    }
+    EXPECT_EQ(rejected, (size_t)std::count(serial_ok.begin(), serial_ok.end(), false)) << "batch=" << batch;
+    EXPECT_EQ(rt_data.seq_ids, serial_seq_ids) << "batch=" << batch;
+    EXPECT_TRUE(rt_data.sensor_data == serial_data) << "batch=" << batch;
+  }
+}
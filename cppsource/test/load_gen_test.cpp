@@ -0,0 +1,42 @@
+#include "load_gen.h"
+#include <gtest/gtest.h>
+
+TEST(LoadGen, Fixed_arrivals_are_evenly_spaced) {
+  arrival_schedule schedule(1000.0, ARRIVALS_FIXED);
+  for (uint64_t i = 0; i < 10000; i++) {
+    ASSERT_EQ(i * 1000000, schedule.next());
+  }
+}
+
+TEST(LoadGen, Poisson_arrivals_keep_the_mean_rate) {
+  arrival_schedule schedule(100000.0, ARRIVALS_POISSON, 7);
+  uint64_t last = 0;
+  uint64_t previous = schedule.next();
+  bool uneven = false;
+  const int count = 100000;
+  for (int i = 0; i < count; i++) {
+    last = schedule.next();
+    ASSERT_GE(last, previous);
+    uneven |= (last - previous) != 10000;
+    previous = last;
+  }
+  EXPECT_TRUE(uneven);
+  // Mean gap 10 us; the sum of 100k gaps is within a few percent
+  EXPECT_NEAR(10000.0, (double)last / count, 300.0);
+}
+
+TEST(LoadGen, Percentiles_are_nearest_rank) {
+  latency_recorder latencies;
+  EXPECT_EQ(0u, latencies.percentile(50.0));
+  for (uint64_t ns = 100; ns >= 1; ns--) {
+    latencies.add(ns);
+  }
+  EXPECT_EQ(100u, latencies.count());
+  EXPECT_EQ(1u, latencies.percentile(0.0));
+  EXPECT_EQ(50u, latencies.percentile(50.0));
+  EXPECT_EQ(99u, latencies.percentile(99.0));
+  EXPECT_EQ(100u, latencies.percentile(99.9));
+  EXPECT_EQ(100u, latencies.max());
+  latencies.add(1000);
+  EXPECT_EQ(1000u, latencies.max());
+}
@@ -0,0 +1,163 @@
+#include "resumable.h"
+#include "run_coro.h"
+#include "prefetch_await.h"
+#include "prefetch1.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
+
+// Item i suspends (i % 5) + 1 times, then marks itself done
+struct coro_test_data {
+  std::vector<int> visits;
+};
+
+static resumable count_coro(const prefetch_false&, coro_test_data& data, size_t index)
+{
+  for (size_t k = 0; k <= index % 5; k++)
+  {
+    co_await suspend_always{};
+  }
+  data.visits[index]++;
+}
+
+// No work at all: the time is the scheduling cost
+static resumable empty_coro(const prefetch_false&, coro_test_data&, size_t)
+{
+  for (int k = 0; k < 8; k++)
+  {
+    co_await suspend_always{};
+  }
+}
+
+template<typename RUNNER_T>
+static void check_runner(size_t tasks, size_t items)
+{
+  prefetch_false prefetcher;
+  coro_test_data data;
+  data.visits.assign(items, 0);
+  RUNNER_T runner(prefetcher, data);
+  runner.run(tasks, items, count_coro);
+  for (size_t i = 0; i < items; i++)
+  {
+    EXPECT_EQ(data.visits[i], 1) << "tasks=" << tasks << " item=" << i;
+  }
+}
+
+TEST(Run_coro, Poll_runs_every_item_once) {
+  for (size_t tasks : {1, 2, 3, 7, 16}) {
+    check_runner<coroutine_runner<prefetch_false, coro_test_data>>(tasks, 100);
+  }
+}
+
+TEST(Run_coro, Ring_runs_every_item_once) {
+  for (size_t tasks : {1, 2, 3, 7, 16}) {
+    check_runner<coroutine_ring_runner<prefetch_false, coro_test_data>>(tasks, 100);
+  }
+  // More tasks than items
+  check_runner<coroutine_ring_runner<prefetch_false, coro_test_data>>(8, 3);
+}
+
+TEST(Run_coro, Resume_overhead) {
+  const size_t items = 20000;
+  prefetch_false prefetcher;
+  coro_test_data data;
+  for (size_t tasks : {2, 8}) {
+    coroutine_runner<prefetch_false, coro_test_data> poll(prefetcher, data);
+    coroutine_ring_runner<prefetch_false, coro_test_data> ring(prefetcher, data);
+    auto t0 = std::chrono::steady_clock::now();
+    poll.run(tasks, items, empty_coro);
+    auto t1 = std::chrono::steady_clock::now();
+    ring.run(tasks, items, empty_coro);
+    auto t2 = std::chrono::steady_clock::now();
+    EXPECT_EQ(ring.resume_count(), items * 9);
+    double poll_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / poll.resume_count();
+    double ring_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / ring.resume_count();
+    RecordProperty("poll_ns_per_resume_" + std::to_string(tasks), std::to_string(poll_ns));
+    RecordProperty("ring_ns_per_resume_" + std::to_string(tasks), std::to_string(ring_ns));
+  }
+}
+
+TEST(Run_coro, Frame_pool_recycles) {
+  const size_t items = 1000;
+  prefetch_false prefetcher;
+  coro_test_data data;
+  data.visits.assign(items, 0);
+  coro_frame_pool pool;
+  {
+    coro_frame_allocator_scope scope(&pool);
+    coroutine_ring_runner<prefetch_false, coro_test_data> ring(prefetcher, data);
+    ring.run(4, items, count_coro);
+    // At most one more frame than tasks is ever live
+    EXPECT_LE(pool.created(), 5u);
+    EXPECT_EQ(pool.created() + pool.recycled(), items);
+  }
+  // Frames made without a pool go back to the heap, even with a pool
+  // installed later
+  resumable heap_task = count_coro(prefetcher, data, 0);
+  {
+    coro_frame_allocator_scope scope(&pool);
+    resumable pooled_task = count_coro(prefetcher, data, 1);
+    EXPECT_EQ(pool.recycled(), items - pool.created() + 1);
+  }
+  EXPECT_EQ(coro_frame_allocator::current(), nullptr);
+}
+
+// As count_coro, for either kind of task
+template<typename TASK_T>
+static TASK_T count_task(const prefetch_false& prefetcher, coro_test_data& data, size_t index)
+{
+  typedef typename coro_task_traits<TASK_T, prefetch_false>::yield_type yield_t;
+  for (size_t k = 0; k <= index % 5; k++)
+  {
+    co_await yield_t(prefetcher);
+  }
+  data.visits[index]++;
+}
+
+template<typename TASK_T>
+static TASK_T empty_task(const prefetch_false& prefetcher, coro_test_data&, size_t)
+{
+  typedef typename coro_task_traits<TASK_T, prefetch_false>::yield_type yield_t;
+  for (int k = 0; k < 8; k++)
+  {
+    co_await yield_t(prefetcher);
+  }
+}
+
+TEST(Run_coro, Symmetric_runs_every_item_once) {
+  prefetch_false prefetcher;
+  for (size_t tasks : {1, 2, 3, 7, 16}) {
+    for (size_t items : {3, 100}) {
+      coro_test_data data;
+      data.visits.assign(items, 0);
+      coroutine_symmetric_runner<prefetch_false, coro_test_data> runner(prefetcher, data);
+      runner.run(tasks, items, count_task<symmetric_task>);
+      for (size_t i = 0; i < items; i++)
+      {
+        EXPECT_EQ(data.visits[i], 1) << "tasks=" << tasks << " items=" << items << " item=" << i;
+      }
+    }
+  }
+}
+
+TEST(Run_coro, Symmetric_switch_overhead) {
+  const size_t items = 20000;
+  prefetch_false prefetcher;
+  coro_test_data data;
+  for (size_t tasks : {2, 8}) {
+    coroutine_ring_runner<prefetch_false, coro_test_data> ring(prefetcher, data);
+    coroutine_symmetric_runner<prefetch_false, coro_test_data> symmetric(prefetcher, data);
+    auto t0 = std::chrono::steady_clock::now();
+    ring.run(tasks, items, empty_task<resumable>);
+    auto t1 = std::chrono::steady_clock::now();
+    symmetric.run(tasks, items, empty_task<symmetric_task>);
+    auto t2 = std::chrono::steady_clock::now();
+    // One switch per suspension, and one per task that completes while
+    // items remain to replace it
+    EXPECT_EQ(symmetric.switch_count(), items * 9 - tasks);
+    double ring_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / ring.resume_count();
+    double symmetric_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / symmetric.switch_count();
+    RecordProperty("ring_ns_per_resume_" + std::to_string(tasks), std::to_string(ring_ns));
+    RecordProperty("symmetric_ns_per_switch_" + std::to_string(tasks), std::to_string(symmetric_ns));
+  }
+}
@@ -0,0 +1,63 @@
+#include <fpm/fixed.hpp>
+#include "svm.h"
+#include "svm_simd.h"
+#include "svm_kernel.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+using P = fpm::fixed<std::int16_t, std::int32_t, 13>;
+
+TEST(SVM_kernel, Neg_exp_table_13) {
+  fixed_neg_exp<13> neg_exp;
+  EXPECT_EQ(neg_exp(0), 8192);
+  EXPECT_EQ(neg_exp(-100), 8192);
+  EXPECT_EQ(neg_exp(40 << 13), 0);
+  for (int64_t a = 0; a < (16 << 13); a += 37) {
+    double expected = std::exp(-(double)a / 8192.0) * 8192.0;
+    EXPECT_NEAR((double)neg_exp(a), expected, 1.0) << "a=" << a;
+  }
+}
+
+TEST(SVM_kernel, Rbf_13_u16) {
+  svm_kernel_evaluator<P> eval({SVM_KERNEL_RBF, P(0.5f), P(0.0f), 1}, svm_dot_kernel(svm_detect_isa()));
+  std::vector<P> s{P(1.0f), P(-0.5f), P(0.25f)};
+  std::vector<P> x{P(0.0f), P(-0.5f), P(0.25f)};
+  int64_t s_norm = eval.norm(s.data(), 3);
+  // K(s, s) = 1
+  EXPECT_EQ(eval.kernel(s.data(), s_norm, s.data(), s_norm, 3), 8192);
+  // |x - s|^2 = 1, so K = exp(-0.5)
+  EXPECT_NEAR((double)eval.kernel(x.data(), eval.norm(x.data(), 3), s.data(), s_norm, 3),
+    std::exp(-0.5) * 8192.0, 1.0);
+}
+
+TEST(SVM_kernel, Poly_13_u16) {
+  svm_kernel_evaluator<P> eval({SVM_KERNEL_POLY, P(0.5f), P(1.0f), 3}, svm_dot_scalar);
+  std::vector<P> s{P(1.0f), P(1.0f)};
+  std::vector<P> x{P(1.0f), P(0.5f)};
+  // (0.5 * 1.5 + 1)^3 = 1.75^3 = 5.359375
+  EXPECT_EQ(eval.kernel(x.data(), 0, s.data(), 0, 2), (int64_t)(5.359375 * 8192));
+}
+
+TEST(SVM_kernel, Decision_13_u16) {
+  svm_kernel_evaluator<P> eval({SVM_KERNEL_RBF, P(1.0f), P(0.0f), 1}, svm_dot_scalar);
+  // Two support vectors { alpha, s0, s1 }: +1 at (1, 0), -1 at (0, 1)
+  std::vector<P> model{P(1.0f), P(1.0f), P(0.0f),
+                       P(-1.0f), P(0.0f), P(1.0f)};
+  std::vector<int64_t> norms{eval.norm(model.data() + 1, 2), eval.norm(model.data() + 4, 2)};
+  std::vector<P> near0{P(0.9f), P(0.1f)};
+  std::vector<P> near1{P(0.1f), P(0.9f)};
+  EXPECT_EQ((svm_kernel_infer(eval, model.data(), 3, 2, norms.data(), P(0.0f), near0.data(), 2)), true);
+  EXPECT_EQ((svm_kernel_infer(eval, model.data(), 3, 2, norms.data(), P(0.0f), near1.data(), 2)), false);
+
+  // Accumulating one support vector at a time gives the same totals
+  std::vector<P> rows{P(0.9f), P(0.1f), P(0.1f), P(0.9f)};
+  std::vector<int64_t> x_norms{eval.norm(rows.data(), 2), eval.norm(rows.data() + 2, 2)};
+  std::vector<int64_t> totals(2, 0);
+  for (size_t j = 0; j < 2; j++) {
+    svm_kernel_accumulate(eval, model[3 * j], model.data() + 3 * j + 1, norms[j],
+      rows.data(), x_norms.data(), 2, 2, 2, totals.data());
+  }
+  EXPECT_EQ(eval.decide(totals[0], P(0.0f)), true);
+  EXPECT_EQ(eval.decide(totals[1], P(0.0f)), false);
+}
@@ -0,0 +1,85 @@
+#include <fpm/fixed.hpp>
+#include "svm.h"
+#include "svm_simd.h"
+#include "svm_quant.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using P = fpm::fixed<std::int16_t, std::int32_t, 13>;
+
+TEST(SVM_quant, Kernels_match_scalar) {
+  std::mt19937 engine(1357);
+  std::uniform_int_distribution<int> wdist(-127, 127), xdist(-32768, 32767);
+  for (size_t count : {1, 7, 8, 15, 16, 17, 33, 250, 509, 1000}) {
+    std::vector<int8_t> w(count);
+    std::vector<int16_t> x(count);
+    for (size_t i = 0; i < count; i++) {
+      w[i] = (int8_t)wdist(engine);
+      x[i] = (int16_t)xdist(engine);
+    }
+    int64_t expected = svm_dot_q8_scalar(w.data(), x.data(), count);
+    for (int isa = SVM_ISA_GENERIC; isa < SVM_ISA_COUNT; isa++) {
+      if (!svm_isa_supported((svm_isa_t)isa)) {
+        continue;
+      }
+      EXPECT_EQ(svm_dot_q8_kernel((svm_isa_t)isa)(w.data(), x.data(), count), expected)
+        << svm_isa_name((svm_isa_t)isa) << " count=" << count;
+    }
+  }
+}
+
+TEST(SVM_quant, Quantize) {
+  std::vector<P> w{P(-1.0f), P(0.5f), P(0.0f), P(0.25f)};
+  int64_t scale = svm_q8_scale(svm_max_abs_raw(w.data(), w.size()));
+  std::vector<int8_t> q(w.size());
+  svm_quantize_q8(w.data(), w.size(), scale, q.data());
+  EXPECT_EQ(q[0], -SVM_Q8_MAX);
+  EXPECT_NEAR(q[1], 64, 1);
+  EXPECT_EQ(q[2], 0);
+  EXPECT_NEAR(q[3], 32, 1);
+  // All-zero weights still get a usable scale
+  std::vector<P> z(4, P(0.0f));
+  EXPECT_GE(svm_q8_scale(svm_max_abs_raw(z.data(), z.size())), 1);
+}
+
+TEST(SVM_quant, Decision) {
+  std::vector<P> w{P(-1.0f), P(1.0f), P(-1.0f)};
+  std::vector<P> x1{P(1.0f), P(1.0f), P(1.0f)};
+  std::vector<int8_t> q(w.size());
+  int64_t scale = svm_q8_scale(svm_max_abs_raw(w.data(), w.size()));
+  svm_quantize_q8(w.data(), w.size(), scale, q.data());
+  svm_dot_q8_fn_t dot = svm_dot_q8_kernel(svm_detect_isa());
+  EXPECT_TRUE(svm_infer_q8(dot, q.data(), scale, x1.data(), P(-1.1f), 3));
+  EXPECT_FALSE(svm_infer_q8(dot, q.data(), scale, x1.data(), P(-0.9f), 3));
+}
+
+TEST(SVM_quant, Agrees_with_16_bit) {
+  std::mt19937 engine(8642);
+  std::uniform_int_distribution<int> dist(-8192, 8192);
+  const size_t count = 250, classes = 4, trials = 1000;
+  std::vector<P> bank(classes * (count + 1)), x(count);
+  std::vector<int8_t> q(classes * count);
+  std::vector<P> biases(classes);
+  size_t agreed = 0, agreed_classes = 0;
+  for (size_t t = 0; t < trials; t++) {
+    for (auto& v : bank) v = P::from_raw_value((int16_t)dist(engine));
+    for (auto& v : x) v = P::from_raw_value((int16_t)dist(engine));
+    int32_t max_abs = 0;
+    for (size_t k = 0; k < classes; k++) {
+      bank[k * (count + 1)] = P::from_raw_value((int16_t)(dist(engine) / 8));
+      max_abs = std::max(max_abs, svm_max_abs_raw(bank.data() + k * (count + 1) + 1, count));
+    }
+    int64_t scale = svm_q8_scale(max_abs);
+    for (size_t k = 0; k < classes; k++) {
+      biases[k] = bank[k * (count + 1)];
+      svm_quantize_q8(bank.data() + k * (count + 1) + 1, count, scale, q.data() + k * count);
+    }
+    agreed += svm_infer_q8(svm_dot_q8_scalar, q.data(), scale, x.data(), biases[0], count)
+      == svm_infer_raw(svm_dot_scalar, bank.data() + 1, x.data(), biases[0], count);
+    agreed_classes += svm_infer_q8_argmax(svm_dot_q8_scalar, q.data(), count, scale, biases.data(), classes, x.data(), count)
+      == svm_infer_raw_argmax(svm_dot_block<svm_block_scalar>, bank.data(), count + 1, classes, x.data(), count);
+  }
+  EXPECT_GT(agreed, trials * 95 / 100);
+  EXPECT_GT(agreed_classes, trials * 90 / 100);
+}
@@ -0,0 +1,152 @@
+#include <fpm/fixed.hpp>
+#include "svm.h"
+#include "svm_simd.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using P = fpm::fixed<std::int16_t, std::int32_t, 13>;
+
+TEST(SVM_simd, Kernels_match_scalar) {
+  std::mt19937 engine(1234);
+  std::uniform_int_distribution<int> dist(-32767, 32767);
+  for (size_t count : {1, 7, 8, 15, 16, 17, 33, 250, 509, 1000}) {
+    std::vector<int16_t> w(count), x(count);
+    for (size_t i = 0; i < count; i++) {
+      w[i] = (int16_t)dist(engine);
+      x[i] = (int16_t)dist(engine);
+    }
+    int64_t expected = svm_dot_scalar(w.data(), x.data(), count);
+    for (int isa = SVM_ISA_SCALAR; isa < SVM_ISA_COUNT; isa++) {
+      if (!svm_isa_supported((svm_isa_t)isa)) {
+        continue;
+      }
+      svm_dot_fn_t dot = svm_dot_kernel((svm_isa_t)isa);
+      ASSERT_NE(dot, nullptr);
+      EXPECT_EQ(dot(w.data(), x.data(), count), expected)
+        << svm_isa_name((svm_isa_t)isa) << " count=" << count;
+    }
+  }
+}
+
+TEST(SVM_simd, Decision_13_u16) {
+  std::vector<P> w{P(-1.0f), P(1.0f), P(-1.0f)};
+  std::vector<P> w1{P(1.0f), P(1.0f), P(1.0f)};
+  std::vector<P> x1{P(1.0f), P(1.0f), P(1.0f)};
+  std::vector<P> x{P(1.0f), P(1.0f), P(0.0f)};
+  std::vector<P> xp{P(1.0f), P(1.0f), P(0.0001f)};
+  for (int isa = SVM_ISA_SCALAR; isa < SVM_ISA_COUNT; isa++) {
+    if (!svm_isa_supported((svm_isa_t)isa)) {
+      continue;
+    }
+    svm_dot_fn_t dot = svm_dot_kernel((svm_isa_t)isa);
+    EXPECT_EQ((svm_infer_raw(dot, w.data(), x1.data(), P(-1.1f), 3)), true);
+    EXPECT_EQ((svm_infer_raw(dot, w.data(), x1.data(), P(-0.9f), 3)), false);
+    EXPECT_EQ((svm_infer_raw(dot, w1.data(), x.data(),  P(2.0f), 3)), false); // EQ
+    EXPECT_EQ((svm_infer_raw(dot, w1.data(), xp.data(), P(2.0f), 3)), true ); // GT
+  }
+}
+
+TEST(SVM_simd, Isa_names) {
+  EXPECT_EQ(svm_isa_from_name("generic"), SVM_ISA_GENERIC);
+  EXPECT_EQ(svm_isa_from_name("avx2"), SVM_ISA_AVX2);
+  EXPECT_TRUE(svm_isa_supported(svm_isa_from_name("auto")));
+  EXPECT_THROW(svm_isa_from_name("mmx"), std::domain_error);
+}
+
+TEST(SVM_simd, Block_kernels_match_rows) {
+  std::mt19937 engine(4321);
+  std::uniform_int_distribution<int> dist(-32767, 32767);
+  const size_t max_rows = 11;
+  for (size_t count : {1, 9, 16, 31, 250, 509}) {
+    size_t stride = count + 3;
+    std::vector<int16_t> w(count), x(stride * max_rows);
+    for (auto& v : w) v = (int16_t)dist(engine);
+    for (auto& v : x) v = (int16_t)dist(engine);
+    for (int isa = SVM_ISA_SCALAR; isa < SVM_ISA_COUNT; isa++) {
+      if (!svm_isa_supported((svm_isa_t)isa)) {
+        continue;
+      }
+      svm_dot_block_fn_t dot_block = svm_dot_block_kernel((svm_isa_t)isa);
+      ASSERT_NE(dot_block, nullptr);
+      for (size_t rows = 1; rows <= max_rows; rows++) {
+        std::vector<int64_t> totals(rows);
+        dot_block(w.data(), x.data(), stride, rows, count, totals.data());
+        for (size_t r = 0; r < rows; r++) {
+          EXPECT_EQ(totals[r], svm_dot_scalar(w.data(), x.data() + r * stride, count))
+            << svm_isa_name((svm_isa_t)isa) << " rows=" << rows << " r=" << r;
+        }
+      }
+    }
+  }
+}
+
+TEST(SVM_simd, Block_decision_13_u16) {
+  std::vector<P> w{P(1.0f), P(1.0f), P(1.0f)};
+  // Rows: EQ, GT, LT, GT
+  std::vector<P> x{P(1.0f), P(1.0f), P(0.0f),
+                   P(1.0f), P(1.0f), P(0.0001f),
+                   P(1.0f), P(1.0f), P(-0.0001f),
+                   P(1.0f), P(1.0f), P(1.0f)};
+  for (int isa = SVM_ISA_SCALAR; isa < SVM_ISA_COUNT; isa++) {
+    if (!svm_isa_supported((svm_isa_t)isa)) {
+      continue;
+    }
+    svm_dot_block_fn_t dot_block = svm_dot_block_kernel((svm_isa_t)isa);
+    EXPECT_EQ((svm_infer_raw_block(dot_block, w.data(), x.data(), 3, 4, P(2.0f), 3)), 0xAu);
+  }
+}
+
+TEST(SVM_simd, Argmax_matches_generic) {
+  std::mt19937 engine(777);
+  std::uniform_int_distribution<int> dist(-8192, 8192);
+  const size_t count = 509;
+  const size_t stride = count + 1;
+  for (size_t classes = 1; classes <= SVM_MAX_CLASSES; classes++) {
+    std::vector<P> bank(stride * classes), x(count);
+    for (auto& v : bank) v = P::from_raw_value((int16_t)dist(engine));
+    for (auto& v : x) v = P::from_raw_value((int16_t)dist(engine));
+    size_t expected = svm_infer_argmax<P, wide_accumulator<int64_t> >(bank.data(), stride, classes, x.data(), count);
+    for (int isa = SVM_ISA_SCALAR; isa < SVM_ISA_COUNT; isa++) {
+      if (!svm_isa_supported((svm_isa_t)isa)) {
+        continue;
+      }
+      svm_dot_block_fn_t dot_block = svm_dot_block_kernel((svm_isa_t)isa);
+      EXPECT_EQ((svm_infer_raw_argmax(dot_block, bank.data(), stride, classes, x.data(), count)), expected)
+        << svm_isa_name((svm_isa_t)isa) << " classes=" << classes;
+    }
+  }
+}
+
+TEST(SVM_simd, Early_exit_matches_full) {
+  std::mt19937 engine(2468);
+  std::uniform_int_distribution<int> wdist(-8192, 8192), xdist(-8192, 8192);
+  const size_t count = 509, chunk = 32;
+  std::vector<P> w(count), wp(count), x(count), xp(count);
+  std::vector<uint16_t> order(count);
+  std::vector<int64_t> bounds((count + chunk - 1) / chunk + 1);
+  size_t touched_total = 0;
+  for (int trial = 0; trial < 100; trial++) {
+    for (size_t i = 0; i < count; i++) {
+      w[i] = P::from_raw_value((int16_t)(wdist(engine) >> (i % 8)));
+      x[i] = P::from_raw_value((int16_t)xdist(engine));
+    }
+    svm_magnitude_order(w.data(), count, order.data());
+    for (size_t i = 0; i < count; i++) {
+      wp[i] = w[order[i]];
+      xp[i] = x[order[i]];
+    }
+    for (size_t i = 1; i < count; i++) {
+      ASSERT_GE(std::abs(wp[i - 1].raw_value()), std::abs(wp[i].raw_value()));
+    }
+    svm_suffix_bounds(wp.data(), count, 8192, chunk, bounds.data());
+    EXPECT_EQ(bounds.back(), 0);
+    P bias = P::from_raw_value((int16_t)(wdist(engine) / 64));
+    size_t touched;
+    EXPECT_EQ(svm_infer_raw_early_exit(svm_dot_scalar, wp.data(), xp.data(), bias, count, bounds.data(), chunk, touched),
+      svm_infer_raw(svm_dot_scalar, w.data(), x.data(), bias, count));
+    EXPECT_LE(touched, count);
+    touched_total += touched;
+  }
+  EXPECT_LT(touched_total, 100 * count);
+}
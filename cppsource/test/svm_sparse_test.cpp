@@ -0,0 +1,61 @@
+#include <fpm/fixed.hpp>
+#include "svm.h"
+#include "svm_simd.h"
+#include "svm_sparse.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using P = fpm::fixed<std::int16_t, std::int32_t, 13>;
+
+TEST(SVM_sparse, Find_bands) {
+  std::vector<P> w(40, P(0.0f));
+  w[2] = P(0.5f);
+  w[5] = P(-0.5f); // Gap of 2: same band
+  w[20] = P(1.0f); // Gap of 14: new band
+  w[21] = P(1.0f);
+  w[39] = P(0.25f);
+  std::vector<svm_band_t> bands;
+  std::vector<P> values;
+  ASSERT_EQ(svm_find_bands(w.data(), w.size(), SVM_BAND_MIN_GAP, bands, values), 3u);
+  EXPECT_EQ(bands[0].start, 2);
+  EXPECT_EQ(bands[0].length, 4);
+  EXPECT_EQ(bands[1].start, 20);
+  EXPECT_EQ(bands[1].length, 2);
+  EXPECT_EQ(bands[2].start, 39);
+  EXPECT_EQ(bands[2].length, 1);
+  EXPECT_EQ(values.size(), svm_band_items(bands.data(), bands.size()));
+  EXPECT_EQ(values[3], P(-0.5f));
+
+  std::vector<P> zeros(16, P(0.0f));
+  bands.clear();
+  values.clear();
+  EXPECT_EQ(svm_find_bands(zeros.data(), zeros.size(), SVM_BAND_MIN_GAP, bands, values), 0u);
+}
+
+TEST(SVM_sparse, Matches_dense) {
+  std::mt19937 engine(9753);
+  std::uniform_int_distribution<int> dist(-8192, 8192), pos(0, 499);
+  const size_t count = 500;
+  for (int trial = 0; trial < 50; trial++) {
+    std::vector<P> w(count, P(0.0f)), x(count);
+    for (int b = 0; b < 3; b++) {
+      size_t start = pos(engine), len = 1 + pos(engine) % 40;
+      for (size_t i = start; i < std::min(count, start + len); i++) {
+        w[i] = P::from_raw_value((int16_t)dist(engine));
+      }
+    }
+    for (auto& v : x) v = P::from_raw_value((int16_t)dist(engine));
+    std::vector<svm_band_t> bands;
+    std::vector<P> values;
+    svm_find_bands(w.data(), count, SVM_BAND_MIN_GAP, bands, values);
+    int64_t dense = svm_dot_scalar(reinterpret_cast<const int16_t*>(w.data()),
+      reinterpret_cast<const int16_t*>(x.data()), count);
+    svm_dot_fn_t dot = svm_dot_kernel(svm_detect_isa());
+    EXPECT_EQ(svm_dot_bands(dot, bands.data(), bands.size(),
+      reinterpret_cast<const int16_t*>(values.data()), reinterpret_cast<const int16_t*>(x.data())), dense);
+    P bias = P::from_raw_value((int16_t)(dist(engine) / 8));
+    EXPECT_EQ(svm_infer_bands(dot, bands.data(), bands.size(), values.data(), x.data(), bias),
+      svm_infer_raw(dot, w.data(), x.data(), bias, count));
+  }
+}
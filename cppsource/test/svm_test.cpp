@@ -34,3 +34,75 @@ TEST(SVM, Eq_13_u16) {
   EXPECT_EQ((svm_infer(w.data(), xn.data(), P(2.0f), 3)), false); // LT
 }
 
+
+TEST(SVM, Overflow_wide_13_u16) {
+  using P = fpm::fixed<std::int16_t, std::int32_t, 13>;
+  // 64 x 0.5 = 32.0 is far outside Q3.13, so a narrow total wraps
+  std::vector<P> w(64, P(1.0f));
+  std::vector<P> xp(64, P(0.5f));
+  std::vector<P> xn(64, P(-0.5f));
+  EXPECT_EQ((svm_infer<P, wide_accumulator<std::int64_t> >(w.data(), xp.data(), P(3.0f), 64)), true);
+  EXPECT_EQ((svm_infer<P, wide_accumulator<std::int64_t> >(w.data(), xn.data(), P(-3.0f), 64)), false);
+  EXPECT_EQ((svm_infer<P, wide_accumulator<std::int32_t> >(w.data(), xp.data(), P(3.0f), 60)), true);
+  EXPECT_EQ((svm_infer<P, wide_accumulator<std::int32_t> >(w.data(), xn.data(), P(-3.0f), 60)), false);
+}
+
+TEST(SVM, Long_wide_13_u16) {
+  using P = fpm::fixed<std::int16_t, std::int32_t, 13>;
+  // 1000 bins: running sum reaches +250.0 then returns to 0.0 + 1 LSB
+  std::vector<P> w(1001, P(0.5f));
+  std::vector<P> x(1001, P(1.0f));
+  std::fill(x.begin() + 500, x.end(), P(-1.0f));
+  x[1000] = P::from_raw_value(2);
+  EXPECT_EQ((svm_infer<P, wide_accumulator<std::int64_t> >(w.data(), x.data(), P(0.0f), 1001)), true);
+  x[1000] = P(0.0f);
+  EXPECT_EQ((svm_infer<P, wide_accumulator<std::int64_t> >(w.data(), x.data(), P(0.0f), 1001)), false); // EQ
+}
+
+TEST(SVM, Eq_wide_13_u16) {
+  using P = fpm::fixed<std::int16_t, std::int32_t, 13>;
+  std::vector<P> w{P(1.0f), P(1.0f), P(1.0f)};
+  std::vector<P> x{P(1.0f), P(1.0f), P(0.0f)};
+  std::vector<P> xp{P(1.0f), P(1.0f), P(0.0001f)};
+  std::vector<P> xn{P(1.0f), P(1.0f), P(-0.0001f)};
+  EXPECT_EQ((svm_infer<P, wide_accumulator<std::int64_t> >(w.data(), x.data(),  P(2.0f), 3)), false); // EQ
+  EXPECT_EQ((svm_infer<P, wide_accumulator<std::int64_t> >(w.data(), xp.data(), P(2.0f), 3)), true ); // GT
+  EXPECT_EQ((svm_infer<P, wide_accumulator<std::int64_t> >(w.data(), xn.data(), P(2.0f), 3)), false); // LT
+}
+
+TEST(SVM, Block_matches_rows_13_u16) {
+  using P = fpm::fixed<std::int16_t, std::int32_t, 13>;
+  std::vector<P> w{P(-1.0f), P(1.0f), P(-1.0f)};
+  std::vector<P> x{P(1.0f), P(1.0f), P(1.0f),
+                   P(-1.0f), P(-1.0f), P(-1.0f),
+                   P(0.5f), P(-0.5f), P(0.25f)};
+  for (float b : {-1.1f, -0.9f, 0.9f, 1.1f}) {
+    uint32_t expected = 0;
+    for (size_t r = 0; r < 3; r++) {
+      if (svm_infer(w.data(), x.data() + 3 * r, P(b), 3)) {
+        expected |= 1u << r;
+      }
+    }
+    EXPECT_EQ((svm_infer_block(w.data(), x.data(), 3, 3, P(b), 3)), expected);
+    EXPECT_EQ((svm_infer_block<P, wide_accumulator<std::int64_t> >(w.data(), x.data(), 3, 3, P(b), 3)), expected);
+  }
+}
+
+TEST(SVM, Argmax_13_u16) {
+  using P = fpm::fixed<std::int16_t, std::int32_t, 13>;
+  // Bank of 3 classes: { bias, w0, w1, w2 }
+  std::vector<P> bank{P(0.0f), P(1.0f), P(0.0f), P(0.0f),
+                      P(0.0f), P(0.0f), P(1.0f), P(0.0f),
+                      P(0.5f), P(0.0f), P(1.0f), P(1.0f)};
+  std::vector<P> x0{P(1.0f), P(0.5f), P(0.0f)};
+  std::vector<P> x1{P(0.5f), P(1.0f), P(0.25f)};
+  std::vector<P> x2{P(0.5f), P(1.0f), P(0.75f)};
+  EXPECT_EQ((svm_infer_argmax(bank.data(), 4, 3, x0.data(), 3)), 0u);
+  EXPECT_EQ((svm_infer_argmax(bank.data(), 4, 3, x1.data(), 3)), 1u);
+  EXPECT_EQ((svm_infer_argmax(bank.data(), 4, 3, x2.data(), 3)), 2u);
+  EXPECT_EQ((svm_infer_argmax<P, wide_accumulator<std::int64_t> >(bank.data(), 4, 3, x0.data(), 3)), 0u);
+  EXPECT_EQ((svm_infer_argmax<P, wide_accumulator<std::int64_t> >(bank.data(), 4, 3, x1.data(), 3)), 1u);
+  EXPECT_EQ((svm_infer_argmax<P, wide_accumulator<std::int64_t> >(bank.data(), 4, 3, x2.data(), 3)), 2u);
+  // A single-row bank always gives class 0
+  EXPECT_EQ((svm_infer_argmax(bank.data(), 4, 1, x2.data(), 3)), 0u);
+}
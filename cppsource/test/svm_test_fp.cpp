@@ -32,3 +32,25 @@ TEST(SVM_fp, Eq_fix_t) {
   EXPECT_EQ((svm_infer(w.data(), xn.data(), P(2.0f), 3)), false); // LT
 }
 
+
+TEST(SVM_fp, Overflow_wide_fix_t) {
+  // 64 x 0.5 = 32.0 is far outside Q3.13, so a narrow total wraps
+  std::vector<fix_t> w(64, P(1.0f));
+  std::vector<fix_t> xp(64, P(0.5f));
+  std::vector<fix_t> xn(64, P(-0.5f));
+  EXPECT_EQ((svm_infer<fix_t, wide_accumulator<wide_t> >(w.data(), xp.data(), P(3.0f), 60)), true);
+  EXPECT_EQ((svm_infer<fix_t, wide_accumulator<wide_t> >(w.data(), xn.data(), P(-3.0f), 60)), false);
+  EXPECT_EQ((svm_infer<fix_t, wide_accumulator<int64_t> >(w.data(), xp.data(), P(3.0f), 64)), true);
+  EXPECT_EQ((svm_infer<fix_t, wide_accumulator<int64_t> >(w.data(), xn.data(), P(-3.0f), 64)), false);
+}
+
+TEST(SVM_fp, Long_wide_fix_t) {
+  // 1000 bins: running sum reaches +250.0 then returns to 0.0 + 1 LSB
+  std::vector<fix_t> w(1001, P(0.5f));
+  std::vector<fix_t> x(1001, P(1.0f));
+  std::fill(x.begin() + 500, x.end(), P(-1.0f));
+  x[1000] = 2;
+  EXPECT_EQ((svm_infer<fix_t, wide_accumulator<int64_t> >(w.data(), x.data(), P(0.0f), 1001)), true);
+  x[1000] = 0;
+  EXPECT_EQ((svm_infer<fix_t, wide_accumulator<int64_t> >(w.data(), x.data(), P(0.0f), 1001)), false); // EQ
+}
@@ -0,0 +1,51 @@
+#include "udp_batch.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+// Sends count datagrams of size bytes to port on loopback; byte 0 holds the index
+static void send_datagrams(uint16_t port, size_t count, size_t size)
+{
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  ASSERT_GE(fd, 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  std::vector<char> payload(size, 0);
+  for (size_t i = 0; i < count; i++) {
+    payload[0] = (char)i;
+    ASSERT_EQ(sendto(fd, payload.data(), size, 0, (struct sockaddr*)&addr, sizeof(addr)), (ssize_t)size);
+  }
+  close(fd);
+}
+
+TEST(Udp_batch, Drains_queued_datagrams_in_batches) {
+  udp_batch_socket sock(0, 256, 16, 200, 1 << 20);
+  ASSERT_NE(sock.port(), 0);
+  send_datagrams(sock.port(), 40, 256);
+  std::vector<int> seen;
+  size_t n;
+  while ((n = sock.receive()) > 0) {
+    for (size_t i = 0; i < n; i++) {
+      EXPECT_EQ(sock.length(i), 256u);
+      EXPECT_FALSE(sock.truncated(i));
+      seen.push_back(sock.data(i)[0]);
+    }
+  }
+  ASSERT_EQ(seen.size(), 40u);
+  for (int i = 0; i < 40; i++) {
+    EXPECT_EQ(seen[i], i);
+  }
+  // 3 full or partial batches, then the timeout
+  EXPECT_EQ(sock.datagram_count(), 40u);
+  EXPECT_EQ(sock.syscall_count(), 4u);
+}
+
+TEST(Udp_batch, Flags_truncated_datagrams) {
+  udp_batch_socket sock(0, 64, 4, 200);
+  send_datagrams(sock.port(), 1, 100);
+  ASSERT_EQ(sock.receive(), 1u);
+  EXPECT_TRUE(sock.truncated(0));
+  EXPECT_EQ(sock.receive(), 0u);
+}
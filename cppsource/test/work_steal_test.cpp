@@ -0,0 +1,71 @@
+#include "work_steal.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+
+TEST(Work_steal, Ranges_cover_every_item_once) {
+  work_steal_ranges ranges;
+  ranges.reset(3, 10);
+  std::vector<int> taken(10, 0);
+  size_t item;
+  // Worker 0 takes its own items, then steals the rest
+  work_steal_source source(ranges, 0);
+  while (source.next(item))
+  {
+    ASSERT_LT(item, 10u);
+    taken[item]++;
+  }
+  for (size_t i = 0; i < taken.size(); i++)
+  {
+    EXPECT_EQ(taken[i], 1) << "item " << i;
+  }
+  EXPECT_GT(ranges.steal_count(), 0u);
+  EXPECT_FALSE(ranges.take(1, item));
+  EXPECT_FALSE(ranges.steal(2));
+}
+
+TEST(Work_steal, Pool_runs_every_item_once) {
+  const size_t items = 10000;
+  std::vector<std::atomic<int> > taken(items);
+  worker_pool pool(4);
+  for (size_t active : {1, 2, 4}) {
+    for (auto& t : taken) {
+      t.store(0);
+    }
+    work_steal_ranges ranges;
+    ranges.reset(active, items);
+    worker_pool::job_t job = [&](size_t worker) {
+      work_steal_source source(ranges, worker);
+      size_t item;
+      while (source.next(item))
+      {
+        taken[item].fetch_add(1);
+      }
+    };
+    pool.run(active, job);
+    for (size_t i = 0; i < items; i++)
+    {
+      ASSERT_EQ(taken[i].load(), 1) << "active=" << active << " item=" << i;
+    }
+  }
+}
+
+#if __linux__
+TEST(Work_steal, Pool_restores_caller_affinity) {
+  cpu_set_t before, after;
+  ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(before), &before), 0);
+  {
+    worker_pool pool(2);
+    worker_pool::job_t job = [](size_t) {};
+    pool.run(2, job);
+    ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(after), &after), 0);
+    EXPECT_TRUE(CPU_EQUAL(&before, &after));
+  }
+}
+#endif
+
+TEST(Work_steal, Line_allocator_owns_whole_lines) {
+  std::vector<int, line_allocator<int> > a(3), b(5);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(a.data()) % LINE_SIZE, 0u);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(b.data()) % LINE_SIZE, 0u);
+}
@@ -0,0 +1,295 @@
+// Companion sender for infer7 -p: transmits simulated sensor datagrams
+// over UDP, period by period, in batches with sendmmsg.
+//
+// The sensor IDs are those infer7 generates (uuid.h, fixed seed), so
+// both sides must be given the same sensor count. Each period sends
+// sample 0 of every sensor, then sample 1, and so on, and ends with
+// CMD_ID_RESET_SEQUENCES; the last period is followed by
+// CMD_ID_STOP_SERVER.
+
+#include <tclap/CmdLine.h>
+#include <array>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <uuid.h>
+#include <commands.h>
+
+// Datagram layout shared with infer7: sensor UUID, sequence number,
+// then 16-bit fixed point (3.13) amplitudes
+#define HEADER_BYTES (UUID_SIZE + sizeof(uint32_t))
+
+const char *pattern_names[] = {
+    "none",
+    "seq",
+    "coro",
+    "both",
+    0};
+const uint32_t pattern_commands[] = { 0, CMD_ID_USE_SEQ, CMD_ID_USE_CORO, CMD_ID_USE_BOTH };
+
+struct transmit_settings_t
+{
+  uint32_t sensor_count;
+  uint32_t sample_count;
+  uint32_t datagram_size;
+  uint32_t repeats;
+  std::string host;
+  uint16_t port;
+  uint16_t batch;
+  uint32_t gap_us; // Pause after each batch
+  uint32_t between_ms; // Pause after each period
+  int pattern;
+  uint16_t verbosity;
+};
+
+bool parse_cmd_line(int argc, char **argv, transmit_settings_t &ts)
+{
+  try
+  {
+    TCLAP::CmdLine cmd("Sensor datagram transmitter for infer7", ' ', "0.1");
+
+    TCLAP::ValueArg<uint32_t> sensor_count_arg("s", "sensors", "Number of sensors", true, 0, "positive integer");
+    TCLAP::ValueArg<uint32_t> sample_count_arg("c", "samples", "Number of samples per sensor per period", true, 0, "positive integer");
+    TCLAP::ValueArg<uint32_t> datagram_size_arg("d", "datagram", "Datagram size in bytes", true, 0, "positive integer");
+    TCLAP::ValueArg<uint32_t> repeats_arg("a", "repeats", "Number of periods", false, 1, "positive integer");
+    TCLAP::ValueArg<std::string> host_arg("", "host", "Receiver IPv4 address", false, "127.0.0.1", "dotted quad");
+    TCLAP::ValueArg<uint16_t> port_arg("p", "port", "Receiver UDP port", true, 0, "positive integer");
+    TCLAP::ValueArg<uint16_t> batch_arg("", "batch", "Datagrams per sendmmsg call (1-1024)", false, 64, "positive integer");
+    TCLAP::ValueArg<uint32_t> gap_arg("g", "gap_us", "Pause after each batch (us)", false, 0, "non-negative integer");
+    TCLAP::ValueArg<uint32_t> between_arg("e", "between", "Pause after each period (ms)", false, 100, "non-negative integer");
+    TCLAP::ValueArg<std::string> pattern_arg("", "pattern", "Execution pattern to ask for (none, seq, coro, both)", false, "none", "pattern name");
+    TCLAP::ValueArg<uint16_t> verbosity_arg("v", "verbosity", "Verbosity level (0 is quiet)", false, 1, "non-negative integer");
+
+    cmd.add(sensor_count_arg);
+    cmd.add(sample_count_arg);
+    cmd.add(datagram_size_arg);
+    cmd.add(repeats_arg);
+    cmd.add(host_arg);
+    cmd.add(port_arg);
+    cmd.add(batch_arg);
+    cmd.add(gap_arg);
+    cmd.add(between_arg);
+    cmd.add(pattern_arg);
+    cmd.add(verbosity_arg);
+    cmd.parse(argc, argv);
+
+    ts.sensor_count = sensor_count_arg.getValue();
+    ts.sample_count = sample_count_arg.getValue();
+    ts.datagram_size = datagram_size_arg.getValue();
+    ts.repeats = repeats_arg.getValue();
+    ts.host = host_arg.getValue();
+    ts.port = port_arg.getValue();
+    ts.batch = batch_arg.getValue();
+    ts.gap_us = gap_arg.getValue();
+    ts.between_ms = between_arg.getValue();
+    ts.verbosity = verbosity_arg.getValue();
+    ts.pattern = -1;
+    for (int i = 0; pattern_names[i]; i++)
+    {
+      if (pattern_arg.getValue() == pattern_names[i])
+      {
+        ts.pattern = i;
+      }
+    }
+
+    if (ts.sensor_count == 0 || ts.sample_count == 0)
+    {
+      throw std::domain_error("sensors and samples must be positive");
+    }
+    if (ts.datagram_size <= HEADER_BYTES)
+    {
+      throw std::domain_error("datagram_size must be larger than the header (" + std::to_string(HEADER_BYTES) + ")");
+    }
+    if (ts.batch == 0 || ts.batch > 1024)
+    {
+      throw std::domain_error("batch must be a positive integer no greater than 1024");
+    }
+    if (ts.pattern < 0)
+    {
+      throw std::domain_error("pattern must be one of none, seq, coro, both");
+    }
+    return true;
+  }
+  catch (const TCLAP::ArgException &e)
+  {
+    std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+    return false;
+  }
+  catch (const std::exception &ex)
+  {
+    std::cerr << "validation error: " << ex.what() << std::endl;
+    return false;
+  }
+}
+
+/**
+ * @brief Queues datagrams into a slab and sends them batch at a time
+ */
+class batch_sender
+{
+public:
+  batch_sender(int fd, const sockaddr_in& to, size_t datagram_size, size_t batch, uint32_t gap_us)
+    : fd_(fd), to_(to), datagram_size_(datagram_size), gap_us_(gap_us),
+      slab_(datagram_size * batch), iov_(batch), msgs_(batch)
+  {
+    for (size_t i = 0; i < batch; i++)
+    {
+      iov_[i].iov_base = slab_.data() + (i * datagram_size_);
+      iov_[i].iov_len = datagram_size_;
+      memset(&msgs_[i], 0, sizeof(msgs_[i]));
+      msgs_[i].msg_hdr.msg_iov = &iov_[i];
+      msgs_[i].msg_hdr.msg_iovlen = 1;
+      msgs_[i].msg_hdr.msg_name = &to_;
+      msgs_[i].msg_hdr.msg_namelen = sizeof(to_);
+    }
+  }
+  // The next free slot; call push() once it is filled
+  char* slot() { return slab_.data() + (queued_ * datagram_size_); }
+  bool push()
+  {
+    return (++queued_ < msgs_.size()) || flush();
+  }
+  bool flush()
+  {
+    size_t sent = 0;
+    while (sent < queued_)
+    {
+      syscalls_++;
+      int n = sendmmsg(fd_, msgs_.data() + sent, (unsigned)(queued_ - sent), 0);
+      if (n < 0)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+        perror("sendmmsg");
+        return false;
+      }
+      sent += n;
+    }
+    datagrams_ += queued_;
+    queued_ = 0;
+    if (gap_us_)
+    {
+      std::this_thread::sleep_for(std::chrono::microseconds(gap_us_));
+    }
+    return true;
+  }
+  uint64_t datagram_count() const { return datagrams_; }
+  uint64_t syscall_count() const { return syscalls_; }
+private:
+  int fd_;
+  sockaddr_in to_;
+  size_t datagram_size_;
+  uint32_t gap_us_;
+  std::vector<char> slab_;
+  std::vector<struct iovec> iov_;
+  std::vector<struct mmsghdr> msgs_;
+  size_t queued_ = 0;
+  uint64_t datagrams_ = 0;
+  uint64_t syscalls_ = 0;
+};
+
+// Fills a slot with a command frame: all-ones sensor ID, the command, zeros
+static void fill_command(char* slot, size_t datagram_size, uint32_t cmd)
+{
+  memset(slot, 0xff, UUID_SIZE);
+  memcpy(slot + UUID_SIZE, &cmd, sizeof(cmd));
+  memset(slot + HEADER_BYTES, 0, datagram_size - HEADER_BYTES);
+}
+
+int main(int argc, char **argv)
+{
+  transmit_settings_t ts;
+  if (!parse_cmd_line(argc, argv, ts))
+  {
+    return -1;
+  }
+
+  // The same IDs, in the same order, as infer7's create_sensor_ids()
+  std::vector<std::array<uint8_t, UUID_SIZE> > sensor_ids(ts.sensor_count);
+  for (auto& id : sensor_ids)
+  {
+    uuid::generate_uuid_v4_num(id.data());
+  }
+
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0)
+  {
+    perror("socket");
+    return 1;
+  }
+  sockaddr_in to;
+  memset(&to, 0, sizeof(to));
+  to.sin_family = AF_INET;
+  to.sin_port = htons(ts.port);
+  if (inet_pton(AF_INET, ts.host.c_str(), &to.sin_addr) != 1)
+  {
+    std::cerr << "Bad host address " << ts.host << std::endl;
+    return 1;
+  }
+
+  batch_sender sender(fd, to, ts.datagram_size, ts.batch, ts.gap_us);
+  size_t amplitude_count = (ts.datagram_size - HEADER_BYTES) / sizeof(int16_t);
+  std::mt19937 engine(5489);
+  // Amplitudes in [-1, 1) as 3.13 fixed point
+  std::uniform_int_distribution<int16_t> amplitude(-(1 << 13), (1 << 13) - 1);
+
+  bool ok = true;
+  if (ts.pattern > 0)
+  {
+    fill_command(sender.slot(), ts.datagram_size, pattern_commands[ts.pattern]);
+    ok = sender.push();
+  }
+  double seconds = 0.0; // Sending, not pausing between periods
+  for (uint32_t period = 0; ok && period < ts.repeats; period++)
+  {
+    auto started_at = std::chrono::steady_clock::now();
+    for (uint32_t seq_id = 0; ok && seq_id < ts.sample_count; seq_id++)
+    {
+      for (uint32_t s = 0; ok && s < ts.sensor_count; s++)
+      {
+        char* slot = sender.slot();
+        memcpy(slot, sensor_ids[s].data(), UUID_SIZE);
+        memcpy(slot + UUID_SIZE, &seq_id, sizeof(seq_id));
+        int16_t* data = reinterpret_cast<int16_t*>(slot + HEADER_BYTES);
+        for (size_t i = 0; i < amplitude_count; i++)
+        {
+          data[i] = amplitude(engine);
+        }
+        ok = sender.push();
+      }
+    }
+    bool last = (period + 1 == ts.repeats);
+    fill_command(sender.slot(), ts.datagram_size, last ? CMD_ID_STOP_SERVER : CMD_ID_RESET_SEQUENCES);
+    ok = ok && sender.push() && sender.flush();
+    seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+    if (!last)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(ts.between_ms));
+    }
+  }
+  close(fd);
+
+  if (ts.verbosity > 0)
+  {
+    std::cout << "datagrams," << sender.datagram_count()
+              << ",syscalls," << sender.syscall_count()
+              << ",seconds," << seconds
+              << ",datagrams_per_s," << (seconds > 0.0 ? (double)sender.datagram_count() / seconds : 0.0)
+              << std::endl;
+  }
+  return ok ? 0 : 1;
+}